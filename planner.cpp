@@ -4,6 +4,7 @@
 #include <regex>
 #include <unordered_set>
 #include <set>
+#include <map>
 #include <list>
 #include <unordered_map>
 #include <algorithm>
@@ -12,6 +13,17 @@
 #include <cassert>
 #include <math.h>       /* ceil */
 #include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <random>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <cstdarg>
 
 
 #define SYMBOLS 0
@@ -32,1527 +44,5724 @@ using namespace std;
 
 bool print_status = true;
 
-class GroundedCondition
+//largest predicate arity an atom can hold, atoms are fixed-size records. Raise it with -DMAX_ATOM_ARGS=<n> for domains
+//with wider predicates, the parser rejects anything above it
+#ifndef MAX_ATOM_ARGS
+#define MAX_ATOM_ARGS 8
+#endif
+
+//maps names (symbols, predicates) to small dense integer ids so that atoms can be compared/hashed without strings
+class intern_table
 {
-private:
-    string predicate;
-    list<string> arg_values;
-    bool truth = true;
+    private:
+        unordered_map<string, int> ids;
+        vector<string> names;
 
-public:
-    GroundedCondition(string predicate, list<string> arg_values, bool truth = true)
-    {
-        this->predicate = predicate;
-        this->truth = truth;  // fixed
-        for (string l : arg_values)
+    public:
+        int intern(const string& name)
         {
-            this->arg_values.push_back(l);
+            auto it = ids.find(name);
+            if(it != ids.end())
+            {
+                return it->second;
+            }
+            int id = names.size();
+            if(id > INT16_MAX) //atoms store ids as int16
+            {
+                throw runtime_error("Too many distinct names, cannot intern " + name);
+            }
+            ids[name] = id;
+            names.push_back(name);
+            return id;
         }
-    }
 
-    GroundedCondition(const GroundedCondition& gc)
-    {
-        this->predicate = gc.predicate;
-        this->truth = gc.truth;  // fixed
-        for (string l : gc.arg_values)
+        //returns -1 if the name was never interned
+        int lookup(const string& name) const
         {
-            this->arg_values.push_back(l);
+            auto it = ids.find(name);
+            if(it == ids.end())
+            {
+                return -1;
+            }
+            return it->second;
         }
-    }
 
-    string get_predicate() const
-    {
-        return this->predicate;
-    }
-    list<string> get_arg_values() const
-    {
-        return this->arg_values;
-    }
+        const string& name(int id) const
+        {
+            return names[id];
+        }
 
-    bool get_truth() const
-    {
-        return this->truth;
-    }
+        int size() const
+        {
+            return names.size();
+        }
+};
 
-    friend ostream& operator<<(ostream& os, const GroundedCondition& pred)
+intern_table symbol_table; //symbols and action parameter names
+intern_table predicate_table;
+
+//fixed-size, trivially copyable predicate instance. Unused args are zeroed so that equality can be checked with memcmp
+struct Atom
+{
+    int16_t predicate;
+    int16_t arity;
+    int16_t args[MAX_ATOM_ARGS];
+    size_t hash_value;
+
+    bool operator==(const Atom& rhs) const
     {
-        os << pred.toString() << " ";
-        return os;
+        return this->hash_value == rhs.hash_value && memcmp(this, &rhs, sizeof(int16_t) * (2 + MAX_ATOM_ARGS)) == 0;
     }
 
-    bool operator==(const GroundedCondition& rhs) const
+    bool operator!=(const Atom& rhs) const
     {
-        if (this->predicate != rhs.predicate || this->arg_values.size() != rhs.arg_values.size())
-            return false;
-
-        auto lhs_it = this->arg_values.begin();
-        auto rhs_it = rhs.arg_values.begin();
-
-        while (lhs_it != this->arg_values.end() && rhs_it != rhs.arg_values.end())
-        {
-            if (*lhs_it != *rhs_it)
-                return false;
-            ++lhs_it;
-            ++rhs_it;
-        }
-
-        if (this->truth != rhs.get_truth()) // fixed
-            return false;
-
-        return true;
+        return !(*this == rhs);
     }
 
     string toString() const
     {
-        string temp = "";
-        temp += this->predicate;
+        string temp = predicate_table.name(this->predicate);
         temp += "(";
-        for (string l : this->arg_values)
+        for(int i = 0; i < this->arity; i++)
         {
-            temp += l + ",";
+            temp += symbol_table.name(this->args[i]) + ",";
         }
         temp = temp.substr(0, temp.length() - 1);
         temp += ")";
         return temp;
     }
-
-  
 };
 
-struct GroundedConditionComparator
+//(re)computes the cached hash once the predicate and args are filled in
+inline void finalize_atom(Atom& atom)
 {
-    bool operator()(const GroundedCondition& lhs, const GroundedCondition& rhs) const
+    size_t h = 1469598103934665603ULL; //FNV-1a over the id fields
+    const int16_t* fields = &atom.predicate;
+    for(int i = 0; i < 2 + atom.arity; i++)
     {
-        return lhs == rhs;
+        h ^= (uint16_t)fields[i];
+        h *= 1099511628211ULL;
     }
-};
+    atom.hash_value = h;
+}
 
-struct GroundedConditionHasher
-{
-    size_t operator()(const GroundedCondition& gcond) const
-    {
-        return hash<string>{}(gcond.toString());
-    }
-};
+static_assert(is_trivially_copyable<Atom>::value, "atoms are copied and compared as raw bytes");
 
-class Condition
+inline Atom make_atom(const string& predicate, const list<string>& args)
 {
-private:
-    string predicate;
-    list<string> args;
-    bool truth;
-
-public:
-    Condition(string pred, list<string> args, bool truth)
+    if(args.size() > MAX_ATOM_ARGS)
     {
-        this->predicate = pred;
-        this->truth = truth;
-        for (string ar : args)
-        {
-            this->args.push_back(ar);
-        }
+        throw runtime_error("Predicate " + predicate + " has " + to_string(args.size()) + " arguments, atoms hold at most " 
+            + to_string(MAX_ATOM_ARGS) + " (rebuild with a larger -DMAX_ATOM_ARGS)");
     }
-
-    string get_predicate() const
+    Atom atom;
+    memset(&atom, 0, sizeof(Atom));
+    atom.predicate = predicate_table.intern(predicate);
+    atom.arity = args.size();
+    int i = 0;
+    for(const string& arg : args)
     {
-        return this->predicate;
+        atom.args[i++] = symbol_table.intern(arg);
     }
+    finalize_atom(atom);
+    return atom;
+}
 
-    list<string> get_args() const
+struct AtomHasher
+{
+    size_t operator()(const Atom& atom) const
     {
-        return this->args;
+        return atom.hash_value;
     }
+};
 
-    bool get_truth() const
+typedef unordered_set<Atom, AtomHasher> atom_set;
+
+inline int popcount64(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for(; word; word &= word - 1)
     {
-        return this->truth;
+        count++;
     }
+    return count;
+#endif
+}
 
-    friend ostream& operator<<(ostream& os, const Condition& cond)
+//index of the lowest set bit, word must be non-zero
+inline int lowest_bit64(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int ind = 0;
+    while(!(word & 1ULL))
     {
-        os << cond.toString() << " ";
-        return os;
+        word >>= 1;
+        ind++;
     }
+    return ind;
+#endif
+}
 
-    bool operator==(const Condition& rhs) const // fixed
-    {
+//assigns every reachable ground atom a dense bit index
+class atom_index
+{
+    private:
+        unordered_map<Atom, int, AtomHasher> ids;
+        vector<Atom> atoms;
 
-        if (this->predicate != rhs.predicate || this->args.size() != rhs.args.size())
-            return false;
+    public:
+        //returns the index of the atom, adding it if it is new
+        int add(const Atom& atom)
+        {
+            auto it = ids.find(atom);
+            if(it != ids.end())
+            {
+                return it->second;
+            }
+            int id = atoms.size();
+            ids[atom] = id;
+            atoms.push_back(atom);
+            return id;
+        }
 
-        auto lhs_it = this->args.begin();
-        auto rhs_it = rhs.args.begin();
+        //returns -1 for atoms that can never become true
+        int lookup(const Atom& atom) const
+        {
+            auto it = ids.find(atom);
+            if(it == ids.end())
+            {
+                return -1;
+            }
+            return it->second;
+        }
 
-        while (lhs_it != this->args.end() && rhs_it != rhs.args.end())
+        const Atom& get(int id) const
         {
-            if (*lhs_it != *rhs_it)
-                return false;
-            ++lhs_it;
-            ++rhs_it;
+            return atoms[id];
         }
 
-        if (this->truth != rhs.get_truth())
-            return false;
+        int size() const
+        {
+            return atoms.size();
+        }
+};
 
-        return true;
-    }
+//read-only view of a packed state whose words live elsewhere (a state_bits, the search arena)
+class state_view
+{
+    private:
+        const uint64_t* words = nullptr;
+        int size = 0;
 
-    string toString() const
-    {
-        string temp = "";
-        if (!this->truth)
-            temp += "!";
-        temp += this->predicate;
-        temp += "(";
-        for (string l : this->args)
+    public:
+        state_view()
         {
-            temp += l + ",";
+            //do nothing
         }
-        temp = temp.substr(0, temp.length() - 1);
-        temp += ")";
-        return temp;
-    }
 
-};
+        state_view(const uint64_t* words_in, int num_words_in) : words(words_in), size(num_words_in)
+        {
+        }
 
-struct ConditionComparator
-{
-    bool operator()(const Condition& lhs, const Condition& rhs) const
-    {
-        return lhs == rhs;
-    }
-};
+        bool test(int atom_id) const
+        {
+            return (words[atom_id >> 6] >> (atom_id & 63)) & 1ULL;
+        }
 
-struct ConditionHasher
-{
-    size_t operator()(const Condition& cond) const
-    {
-        return hash<string>{}(cond.toString());
-    }
-};
+        //true if every bit of the mask is also set in this state
+        bool contains_all(const state_view& mask) const
+        {
+            for(int i = 0; i < size; i++)
+            {
+                if((mask.words[i] & ~words[i]) != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
 
-class Action
-{
-private:
-    string name;
-    list<string> args;
-    unordered_set<Condition, ConditionHasher, ConditionComparator> preconditions;
-    unordered_set<Condition, ConditionHasher, ConditionComparator> effects;
-    
-    //added
-    int num_args; 
+        //number of bits of the mask that are not set in this state
+        int count_missing(const state_view& mask) const
+        {
+            int count = 0;
+            for(int i = 0; i < size; i++)
+            {
+                count += popcount64(mask.words[i] & ~words[i]);
+            }
+            return count;
+        }
 
-    //used for evaluating preconditions/effects
-    unordered_map<string,string> symbol_map;
+        int num_words() const
+        {
+            return size;
+        }
 
+        const uint64_t* data() const
+        {
+            return words;
+        }
 
-public:
-    Action(string name, list<string> args,
-        unordered_set<Condition, ConditionHasher, ConditionComparator>& preconditions,
-        unordered_set<Condition, ConditionHasher, ConditionComparator>& effects,
-        unordered_set<string> symbols)
-    {
-        this->name = name;
-        for (string l : args)
+        uint64_t word(int i) const
         {
-            this->args.push_back(l);
-            this->symbol_map[l] = l; //adding in action-specific symbols
+            return words[i];
         }
-        for (Condition pc : preconditions)
+
+        bool operator==(const state_view& rhs) const
         {
-            this->preconditions.insert(pc);
-            // this->preconditions_tracker.push_back(false);
+            return size == rhs.size && memcmp(words, rhs.words, size * sizeof(uint64_t)) == 0;
         }
-        for (Condition pc : effects)
+
+        bool operator!=(const state_view& rhs) const
         {
-            this->effects.insert(pc);
+            return !(*this == rhs);
         }
-        
-        // printf("Enrolling original symbols\n");
-        // printf("Original: \t Remapped: \n");
+};
+
+//world state as a dense bitset over an atom_index (bit set = atom true), owns its words
+class state_bits
+{
+    private:
+        vector<uint64_t> words;
 
-        for(string symbol: symbols)
+    public:
+        state_bits()
         {
-            symbol_map[symbol] = symbol; // adding in environmental symbols for mapping preconditions/effects
-            // cout<<symbol<<"\t"<<symbol_map[symbol]<<endl;
+            //do nothing
         }
 
-        this->num_args = args.size();
-        
-    }
+        state_bits(int num_atoms) : words((num_atoms + 63) / 64, 0)
+        {
+        }
 
-    string get_name() const
-    {
-        return this->name;
-    }
-    list<string> get_args() const
-    {
-        return this->args;
-    }
-    unordered_set<Condition, ConditionHasher, ConditionComparator> get_preconditions() const
-    {
-        return this->preconditions;
-    }
-    unordered_set<Condition, ConditionHasher, ConditionComparator> get_effects() const
-    {
-        return this->effects;
-    }
+        state_bits(const state_view& state) : words(state.data(), state.data() + state.num_words())
+        {
+        }
 
-    bool operator==(const Action& rhs) const
-    {
-        if (this->get_name() != rhs.get_name() || this->get_args().size() != rhs.get_args().size())
-            return false;
+        state_view view() const
+        {
+            return state_view(words.data(), words.size());
+        }
 
-        return true;
-    }
+        operator state_view() const
+        {
+            return view();
+        }
 
-    friend ostream& operator<<(ostream& os, const Action& ac)
-    {
-        os << ac.toString() << endl;
-        os << "Precondition: ";
-        for (Condition precond : ac.get_preconditions())
-            os << precond;
-        os << endl;
-        os << "Effect: ";
-        for (Condition effect : ac.get_effects())
-            os << effect;
-        os << endl;
-        return os;
-    }
+        bool test(int atom_id) const
+        {
+            return view().test(atom_id);
+        }
 
-    string toString() const
-    {
-        string temp = "";
-        temp += this->get_name();
-        temp += "(";
-        for (string l : this->get_args())
+        void set(int atom_id)
         {
-            temp += l + ",";
+            words[atom_id >> 6] |= 1ULL << (atom_id & 63);
         }
-        temp = temp.substr(0, temp.length() - 1);
-        temp += ")";
-        return temp;
-    }
-    
-    //generates an updated symbol map given arguments
-    unordered_map<string,string> generate_symbol_map(list<string> input_args)
-    {
-        //create temporary copy of map
-        unordered_map<string,string> ret_symbol_map = symbol_map;
 
-        // update values in map to reflect input args (use temporary map)
-        auto input_iter = input_args.begin();
-        for(auto arg_iter = args.begin(); arg_iter != args.end(); arg_iter++)
+        bool contains_all(const state_view& mask) const
         {
-            // cout<< "replacing " <<  temp_symbol_map[arg_iter->data()] << " with " << input_iter->data() << endl; 
-            ret_symbol_map[arg_iter->data()] = input_iter->data(); //looks up key by arguments, and updates with the value of the input args 
-            // cout<< "    validating " <<  arg_iter->data() << " -> " << temp_symbol_map[arg_iter->data()] << endl; 
-            input_iter++;
+            return view().contains_all(mask);
         }
-        return ret_symbol_map;
-    }
 
-    //takes input args and updates the corresponding values in the list using a symbol map
-    list<string> get_remapped_args(list<string> original_args, unordered_map<string,string> sym_map)
-    {
-        list<string> ret_list; 
-        for(auto o_arg : original_args)
+        int count_missing(const state_view& mask) const
         {
-            ret_list.push_back(sym_map[o_arg]); //adds the new mapping to the return list
+            return view().count_missing(mask);
         }
 
-        return ret_list;
-    }
+        int num_words() const
+        {
+            return words.size();
+        }
 
-    void print_umap(unordered_map<string,string> sym_map)
-    {
-        printf("Remapped Arguments: \n");
-        printf("\t Original: \t Remapped: \n");
-        for(auto iter = sym_map.begin(); iter != sym_map.end(); iter++)
+        const uint64_t* data() const
         {
-            cout<<"\t"<< iter->first <<"\t\t"<< iter->second <<endl;
+            return words.data();
         }
-    }
 
-    int get_num_args()
-    {
-        return this->num_args;
-    }
+        uint64_t word(int i) const
+        {
+            return words[i];
+        }
 
-    //will need to make an ungrounded version of this
-    bool preconditions_satisfied( unordered_set<Condition, ConditionHasher, ConditionComparator> beginning_state, list<string> input_args)
-    {
-        
-        unordered_map<string,string> temp_symbol_map = generate_symbol_map(input_args);
-        // print_umap(temp_symbol_map);
-        
-        // iterate over preconditions to determine whether the remapped version is present. If it is, continue searching, if not return false.
-        for(Condition pc: preconditions)
+        bool operator==(const state_bits& rhs) const
         {
-            Condition temp_condition = Condition(pc.get_predicate(),this->get_remapped_args(pc.get_args(), temp_symbol_map) , pc.get_truth());
-            // cout<<"search condition: " << temp_condition.toString() << endl;
-            if(beginning_state.find(temp_condition) == beginning_state.end())
-            {
-                return false;
-            }
+            return view() == rhs.view();
         }
-        return true;
-    }
 
-    //runs action and returns ending conditions
-    unordered_set<Condition, ConditionHasher, ConditionComparator> execute_action(
-        unordered_set<Condition, ConditionHasher, ConditionComparator> beginning_state, 
-        list<string> input_args)
+        bool operator!=(const state_bits& rhs) const
+        {
+            return !(*this == rhs);
+        }
+};
+
+//bump allocator for search memory: objects are carved out of large blocks and all of them are released at once.
+//only trivially destructible objects may live here, destructors are never run
+class search_arena
+{
+    private:
+        vector<char*> blocks;
+        size_t block_size;
+        size_t used; //bytes used in the last block
+
+    public:
+        search_arena(size_t block_size_in = 1 << 20) : block_size(block_size_in), used(block_size_in)
         {
-            //create copy of start condition that will be modified and returned
-            unordered_set<Condition, ConditionHasher, ConditionComparator> end_conditions = beginning_state; 
+        }
 
-            //remap effect conditions with inputs
-            unordered_map<string,string> temp_symbol_map = generate_symbol_map(input_args);
-            // print_umap(temp_symbol_map);
+        //arenas are never shared: a copy starts out empty
+        search_arena(const search_arena& other) : block_size(other.block_size), used(other.block_size)
+        {
+        }
 
-            //update end_conditions with the effects
-            for(Condition effect : effects)
+        search_arena& operator=(const search_arena& other)
+        {
+            if(this != &other)
             {
-                if(effect.get_truth()) //if adding a condition
-                {
-                    Condition temp_condition = Condition(effect.get_predicate(),this->get_remapped_args(effect.get_args(), temp_symbol_map), effect.get_truth());
-                    end_conditions.insert(temp_condition);
-                }
-                else //if removing a condition
-                {
-                    Condition temp_condition = Condition(effect.get_predicate(),this->get_remapped_args(effect.get_args(), temp_symbol_map), true);
-                    end_conditions.erase(temp_condition);
-                }
+                release();
+                block_size = other.block_size;
+                used = block_size;
             }
-
-            return end_conditions;
+            return *this;
         }
 
-    unordered_set<Condition, ConditionHasher, ConditionComparator> execute_action_no_removal(
-        unordered_set<Condition, ConditionHasher, ConditionComparator> beginning_state, 
-        list<string> input_args)
+        ~search_arena()
         {
-            //create copy of start condition that will be modified and returned
-            unordered_set<Condition, ConditionHasher, ConditionComparator> end_conditions = beginning_state; 
-
-            //remap effect conditions with inputs
-            unordered_map<string,string> temp_symbol_map = generate_symbol_map(input_args);
-            // print_umap(temp_symbol_map);
+            release();
+        }
 
-            //update end_conditions with the effects
-            for(Condition effect : effects)
+        void* allocate(size_t bytes, size_t align = alignof(max_align_t))
+        {
+            if(bytes > block_size) //oversized requests get a block of their own, the current block stays in use
             {
-                if(effect.get_truth()) //if adding a condition
-                {
-                    Condition temp_condition = Condition(effect.get_predicate(),this->get_remapped_args(effect.get_args(), temp_symbol_map), effect.get_truth());
-                    end_conditions.insert(temp_condition);
-                }
-                // else //if removing a condition
-                // {
-                //     Condition temp_condition = Condition(effect.get_predicate(),this->get_remapped_args(effect.get_args(), temp_symbol_map), true);
-                //     end_conditions.erase(temp_condition);
-                // }
+                char* big = static_cast<char*>(::operator new(bytes));
+                blocks.insert(blocks.begin(), big);
+                return big;
+            }
+            used = (used + align - 1) & ~(align - 1);
+            if(used + bytes > block_size)
+            {
+                blocks.push_back(static_cast<char*>(::operator new(block_size)));
+                used = 0;
             }
+            void* ret = blocks.back() + used;
+            used += bytes;
+            return ret;
+        }
 
-            return end_conditions;
+        uint64_t* allocate_words(int num_words)
+        {
+            return static_cast<uint64_t*>(allocate(num_words * sizeof(uint64_t), alignof(uint64_t)));
         }
 
+        //frees every block, all pointers handed out become invalid
+        void release()
+        {
+            for(char* block : blocks)
+            {
+                ::operator delete(block);
+            }
+            blocks.clear();
+            used = block_size;
+        }
 };
 
-struct ActionComparator
+//zobrist keys over the atom index: a state's hash is the xor of the keys of its true atoms
+class zobrist_table
 {
-    bool operator()(const Action& lhs, const Action& rhs) const
-    {
-        return lhs == rhs;
-    }
+    private:
+        vector<uint64_t> keys;
+
+    public:
+        void init(int num_atoms, uint64_t seed = 0x9E3779B97F4A7C15ULL)
+        {
+            mt19937_64 rng(seed); //fixed seed so that runs are reproducible
+            keys.resize(num_atoms);
+            for(uint64_t& key : keys)
+            {
+                key = rng();
+            }
+        }
+
+        uint64_t key(int atom_id) const
+        {
+            return keys[atom_id];
+        }
+
+        uint64_t hash(const state_view& state) const
+        {
+            uint64_t h = 0;
+            for(int i = 0; i < state.num_words(); i++)
+            {
+                for(uint64_t word = state.data()[i]; word; word &= word - 1)
+                {
+                    h ^= keys[(i << 6) + lowest_bit64(word)];
+                }
+            }
+            return h;
+        }
 };
 
-struct ActionHasher
+//action instance with all arguments bound, grounded once before search
+struct ground_operator
 {
-    size_t operator()(const Action& ac) const
-    {
-        return hash<string>{}(ac.get_name());
-    }
+    int action; //index into symbo_planner::actions
+    vector<int> args; //interned symbol ids
+    vector<int> pre; //atom ids
+    vector<int> add;
+    vector<int> del;
+    state_bits pre_mask;
+    state_bits add_mask;
+    state_bits del_mask;
 };
 
-class Env
+//successor represented as its parent plus an operator's add/delete delta. Tests, hashing and comparisons
+//work on the delta directly, the full state is only written out once it is actually registered
+class successor_delta
 {
-private:
-    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> initial_conditions;
-    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> goal_conditions;
-    unordered_set<Action, ActionHasher, ActionComparator> actions;
-    unordered_set<string> symbols;
-
-public:
-    void remove_initial_condition(GroundedCondition gc)
-    {
-        this->initial_conditions.erase(gc);
-    }
-    void add_initial_condition(GroundedCondition gc)
-    {
-        this->initial_conditions.insert(gc);
-    }
-    void add_goal_condition(GroundedCondition gc)
-    {
-        this->goal_conditions.insert(gc);
-    }
-    void remove_goal_condition(GroundedCondition gc)
-    {
-        this->goal_conditions.erase(gc);
-    }
-    void add_symbol(string symbol)
-    {
-        symbols.insert(symbol);
-        // sym_map[symbol] = symbol;
-    }
-    void add_symbols(list<string> symbols)
-    {
-        for (string l : symbols)
-            this->symbols.insert(l);
-    }
-    void add_action(Action action)
-    {
-        this->actions.insert(action);
-    }
+    private:
+        state_view parent;
+        const ground_operator* op;
 
-    Action get_action(string name)
-    {
-        for (Action a : this->actions)
+    public:
+        successor_delta(const state_view& parent_in, const ground_operator& op_in) : parent(parent_in), op(&op_in)
         {
-            if (a.get_name() == name)
-                return a;
         }
-        throw runtime_error("Action " + name + " not found!");
-    }
-
-    unordered_set<Action, ActionHasher, ActionComparator> get_actions() const 
-    {
-        return this->actions;
-    }
-
-    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> get_initial_conditions() const
-    {
-        return this->initial_conditions;
-    }
-    
-    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> get_goal_conditions() const
-    {
-        return this->goal_conditions;
-    }
-
-    unordered_set<Condition, ConditionHasher, ConditionComparator> get_initial_ungrounded()
-    {
-        unordered_set<Condition, ConditionHasher, ConditionComparator> ret_val; 
 
-        for(auto ground_it:initial_conditions)
+        uint64_t word(int i) const
         {
-            Condition temp_cond = Condition(ground_it.get_predicate(), ground_it.get_arg_values(), ground_it.get_truth());
-            ret_val.insert(temp_cond);
+            return (parent.data()[i] & ~op->del_mask.data()[i]) | op->add_mask.data()[i];
         }
 
-        return ret_val;
-    }
-
-    unordered_set<Condition, ConditionHasher, ConditionComparator> get_goal_ungrounded()
-    {
-        unordered_set<Condition, ConditionHasher, ConditionComparator> ret_val; 
+        //zobrist hash updated from the parent's, only the operator's effects are visited
+        uint64_t hash(uint64_t parent_hash, const zobrist_table& zobrist) const
+        {
+            uint64_t h = parent_hash;
+            for(int atom_id : op->add)
+            {
+                if(!parent.test(atom_id))
+                {
+                    h ^= zobrist.key(atom_id);
+                }
+            }
+            for(int atom_id : op->del)
+            {
+                if(parent.test(atom_id) && !op->add_mask.test(atom_id))
+                {
+                    h ^= zobrist.key(atom_id);
+                }
+            }
+            return h;
+        }
 
-        for(auto ground_it:goal_conditions)
+        bool operator==(const state_view& other) const
         {
-            Condition temp_cond = Condition(ground_it.get_predicate(), ground_it.get_arg_values(), ground_it.get_truth());
-            ret_val.insert(temp_cond);
+            for(int i = 0; i < parent.num_words(); i++)
+            {
+                if(word(i) != other.data()[i])
+                {
+                    return false;
+                }
+            }
+            return true;
         }
-        return ret_val;
-    }
 
-    unordered_set<string> get_symbols() const
-    {
-        return this->symbols;
-    }
+        void materialize(uint64_t* out) const
+        {
+            for(int i = 0; i < parent.num_words(); i++)
+            {
+                out[i] = word(i);
+            }
+        }
 
-    friend ostream& operator<<(ostream& os, const Env& w)
-    {
-        os << "***** Environment *****" << endl << endl;
-        os << "Symbols: ";
-        for (string s : w.get_symbols())
-            os << s + ",";
-        os << endl;
-        os << "Initial conditions: ";
-        for (GroundedCondition s : w.initial_conditions)
-            os << s;
-        os << endl;
-        os << "Goal conditions: ";
-        for (GroundedCondition g : w.goal_conditions)
-            os << g;
-        os << endl;
-        os << "Actions:" << endl;
-        for (Action g : w.actions)
-            os << g << endl;
-        cout << "***** Environment Created! *****" << endl;
-        return os;
-    }
+        int num_words() const
+        {
+            return parent.num_words();
+        }
 };
 
-class GroundedAction
+//decision tree over precondition atoms that yields only the operators applicable in a state.
+//each inner node tests one atom: operators requiring it live below true_child, the others below dontcare_child
+class successor_generator
 {
-private:
-    string name;
-    list<string> arg_values;
-
-public:
-    GroundedAction(string name, list<string> arg_values)
-    {
-        this->name = name;
-        for (string ar : arg_values)
+    private:
+        struct tree_node
         {
-            this->arg_values.push_back(ar);
-        }
-    }
+            int atom = -1; //-1 for leaves
+            int true_child = -1;
+            int dontcare_child = -1;
+            vector<int> immediate; //operators whose preconditions are all tested on the path to this node
+        };
 
-    string get_name() const
-    {
-        return this->name;
-    }
+        vector<tree_node> nodes;
+        vector<vector<int>> sorted_pre; //per operator, preconditions in increasing atom order
 
-    list<string> get_arg_values() const
-    {
-        return this->arg_values;
-    }
+        //ops holds (operator, number of its preconditions already tested) pairs. Subtrees are expanded from an explicit
+        //work stack: a dontcare chain is as long as the number of distinct precondition atoms, too deep to recurse on
+        void build(vector<pair<int, int>>& ops)
+        {
+            vector<pair<int, vector<pair<int, int>>>> pending; //(node id, operators below that node)
+            nodes.push_back(tree_node());
+            pending.push_back(make_pair(0, vector<pair<int, int>>()));
+            pending.back().second.swap(ops);
 
-    bool operator==(const GroundedAction& rhs) const
-    {
-        if (this->name != rhs.name || this->arg_values.size() != rhs.arg_values.size())
-            return false;
+            while(!pending.empty())
+            {
+                int node_id = pending.back().first;
+                vector<pair<int, int>> node_ops;
+                node_ops.swap(pending.back().second);
+                pending.pop_back();
+
+                int split_atom = -1;
+                for(const pair<int, int>& op : node_ops)
+                {
+                    if(op.second == sorted_pre[op.first].size())
+                    {
+                        nodes[node_id].immediate.push_back(op.first);
+                    }
+                    else if(split_atom < 0 || sorted_pre[op.first][op.second] < split_atom)
+                    {
+                        split_atom = sorted_pre[op.first][op.second];
+                    }
+                }
+                if(split_atom < 0)
+                {
+                    continue;
+                }
+
+                vector<pair<int, int>> with_atom;
+                vector<pair<int, int>> without_atom;
+                for(const pair<int, int>& op : node_ops)
+                {
+                    if(op.second == sorted_pre[op.first].size())
+                    {
+                        continue;
+                    }
+                    if(sorted_pre[op.first][op.second] == split_atom)
+                    {
+                        with_atom.push_back({op.first, op.second + 1});
+                    }
+                    else
+                    {
+                        without_atom.push_back(op);
+                    }
+                }
+
+                nodes[node_id].atom = split_atom;
+                nodes[node_id].true_child = nodes.size();
+                nodes.push_back(tree_node());
+                pending.push_back(make_pair(nodes[node_id].true_child, move(with_atom)));
+                if(!without_atom.empty())
+                {
+                    nodes[node_id].dontcare_child = nodes.size();
+                    nodes.push_back(tree_node());
+                    pending.push_back(make_pair(nodes[node_id].dontcare_child, move(without_atom)));
+                }
+            }
+        }
+
+        void collect(int node_id, const state_view& state, vector<int>& applicable) const
+        {
+            while(node_id >= 0) //the dontcare branch is followed iteratively, only true branches recurse
+            {
+                const tree_node& node = nodes[node_id];
+                applicable.insert(applicable.end(), node.immediate.begin(), node.immediate.end());
+                if(node.atom < 0)
+                {
+                    return;
+                }
+                if(state.test(node.atom))
+                {
+                    collect(node.true_child, state, applicable);
+                }
+                node_id = node.dontcare_child;
+            }
+        }
+
+    public:
+        void init(const vector<ground_operator>& operators)
+        {
+            nodes.clear();
+            sorted_pre.resize(operators.size());
+            vector<pair<int, int>> ops;
+            for(int op_ind = 0; op_ind < operators.size(); op_ind++)
+            {
+                sorted_pre[op_ind] = operators[op_ind].pre;
+                sort(sorted_pre[op_ind].begin(), sorted_pre[op_ind].end());
+                ops.push_back({op_ind, 0});
+            }
+            build(ops);
+            sorted_pre.clear();
+        }
+
+        //appends the ids of the operators applicable in state
+        void generate_applicable(const state_view& state, vector<int>& applicable) const
+        {
+            if(!nodes.empty())
+            {
+                collect(0, state, applicable);
+            }
+        }
+
+        int size() const
+        {
+            return nodes.size();
+        }
+};
+
+const int DEAD_END = INT32_MAX; //heuristic value of states from which the goal is unreachable
+
+//delete-relaxation engine over the ground operators. Atom costs are propagated with a counter-based generalized
+//Dijkstra: every operator keeps a count of unreached preconditions and fires once it drops to zero, so a single
+//evaluation touches each atom and operator a constant number of times (costs are small ints, the queue is bucketed)
+class relaxed_graph
+{
+    public:
+        enum cost_mode { ADDITIVE, MAXIMUM }; //h_add sums precondition costs, h_max takes their maximum
+
+    private:
+        const vector<ground_operator>* operators = nullptr;
+        int num_atoms = 0;
+        vector<int> precondition_of_start; //CSR adjacency: operators having atom a as precondition are
+        vector<int> precondition_of; //precondition_of[precondition_of_start[a] .. precondition_of_start[a+1])
+        vector<int> no_precondition_ops;
+        vector<int> goal_atoms;
+
+        //scratch reused by every evaluation
+        vector<int> atom_cost;
+        vector<int> unsatisfied;
+        vector<int> op_cost;
+        vector<vector<int>> buckets;
+        vector<uint8_t> is_goal_atom;
+        vector<int> supporter; //operator that reached the atom at its current cost, -1 for atoms of the state
+        vector<uint8_t> atom_marked; //relaxed plan extraction marks, reset through marked_atoms/plan
+        vector<uint8_t> op_marked;
+        vector<int> marked_atoms;
+
+        void enqueue(int atom_id, int cost, int op_ind)
+        {
+            if(cost < atom_cost[atom_id])
+            {
+                atom_cost[atom_id] = cost;
+                supporter[atom_id] = op_ind;
+                if(cost >= buckets.size())
+                {
+                    buckets.resize(cost + 1);
+                }
+                buckets[cost].push_back(atom_id);
+            }
+        }
+
+    public:
+        void init(const vector<ground_operator>& operators_in, int num_atoms_in, const state_view& goal)
+        {
+            operators = &operators_in;
+            num_atoms = num_atoms_in;
+
+            precondition_of_start.assign(num_atoms + 1, 0);
+            for(const ground_operator& op : operators_in)
+            {
+                for(int atom_id : op.pre)
+                {
+                    precondition_of_start[atom_id + 1]++;
+                }
+            }
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                precondition_of_start[atom_id + 1] += precondition_of_start[atom_id];
+            }
+            precondition_of.assign(precondition_of_start[num_atoms], 0);
+            vector<int> fill = precondition_of_start;
+            no_precondition_ops.clear();
+            for(int op_ind = 0; op_ind < operators_in.size(); op_ind++)
+            {
+                for(int atom_id : operators_in[op_ind].pre)
+                {
+                    precondition_of[fill[atom_id]++] = op_ind;
+                }
+                if(operators_in[op_ind].pre.empty())
+                {
+                    no_precondition_ops.push_back(op_ind);
+                }
+            }
+
+            goal_atoms.clear();
+            is_goal_atom.assign(num_atoms, 0);
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                if(goal.test(atom_id))
+                {
+                    goal_atoms.push_back(atom_id);
+                    is_goal_atom[atom_id] = 1;
+                }
+            }
+            atom_cost.resize(num_atoms);
+            supporter.resize(num_atoms);
+            atom_marked.assign(num_atoms, 0);
+            unsatisfied.resize(operators_in.size());
+            op_cost.resize(operators_in.size());
+            op_marked.assign(operators_in.size(), 0);
+        }
+
+        //relaxed cost of reaching every goal atom from state, combined according to mode
+        int evaluate(const state_view& state, cost_mode mode)
+        {
+            if(explore(state, mode, true) > 0)
+            {
+                return DEAD_END;
+            }
+            int h = 0;
+            for(int atom_id : goal_atoms)
+            {
+                h = (mode == ADDITIVE) ? h + atom_cost[atom_id] : max(h, atom_cost[atom_id]);
+            }
+            return h;
+        }
+
+        //relaxed cost of every atom from state, DEAD_END for unreachable ones
+        const vector<int>& atom_costs(const state_view& state, cost_mode mode)
+        {
+            explore(state, mode, false);
+            return atom_cost;
+        }
+
+    private:
+        //generalized Dijkstra from state, optionally stopping once every goal atom is settled. Returns the number of
+        //goal atoms left unreached
+        int explore(const state_view& state, cost_mode mode, bool stop_at_goals)
+        {
+            fill(atom_cost.begin(), atom_cost.end(), DEAD_END);
+            fill(op_cost.begin(), op_cost.end(), 0);
+            for(int op_ind = 0; op_ind < operators->size(); op_ind++)
+            {
+                unsatisfied[op_ind] = (*operators)[op_ind].pre.size();
+            }
+            for(vector<int>& bucket : buckets)
+            {
+                bucket.clear();
+            }
+
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                if(state.test(atom_id))
+                {
+                    enqueue(atom_id, 0, -1);
+                }
+            }
+            for(int op_ind : no_precondition_ops)
+            {
+                for(int atom_id : (*operators)[op_ind].add)
+                {
+                    enqueue(atom_id, 1, op_ind); //assumes that all actions have equal cost
+                }
+            }
+
+            int goals_left = goal_atoms.size();
+            for(int cost = 0; cost < buckets.size() && (goals_left > 0 || !stop_at_goals); cost++)
+            {
+                for(int i = 0; i < buckets[cost].size() && (goals_left > 0 || !stop_at_goals); i++)
+                {
+                    int atom_id = buckets[cost][i];
+                    if(atom_cost[atom_id] < cost) //stale entry, the atom was reached cheaper
+                    {
+                        continue;
+                    }
+                    goals_left -= is_goal_atom[atom_id];
+                    for(int j = precondition_of_start[atom_id]; j < precondition_of_start[atom_id + 1]; j++)
+                    {
+                        int op_ind = precondition_of[j];
+                        op_cost[op_ind] = (mode == ADDITIVE) ? op_cost[op_ind] + cost : max(op_cost[op_ind], cost);
+                        if(--unsatisfied[op_ind] == 0)
+                        {
+                            for(int added : (*operators)[op_ind].add)
+                            {
+                                enqueue(added, op_cost[op_ind] + 1, op_ind);
+                            }
+                        }
+                    }
+                }
+            }
+
+            return goals_left;
+        }
+
+    public:
+        //FF heuristic: length of a relaxed plan built backwards from the goals over the h_add best supporters.
+        //If helpful is given it receives the relaxed plan operators that are applicable in state
+        int relaxed_plan(const state_view& state, vector<int>* helpful = nullptr)
+        {
+            if(helpful != nullptr)
+            {
+                helpful->clear();
+            }
+            if(evaluate(state, ADDITIVE) == DEAD_END)
+            {
+                return DEAD_END;
+            }
+
+            vector<int> plan;
+            marked_atoms.assign(goal_atoms.begin(), goal_atoms.end());
+            for(int atom_id : goal_atoms)
+            {
+                atom_marked[atom_id] = 1;
+            }
+            for(int i = 0; i < marked_atoms.size(); i++)
+            {
+                int op_ind = supporter[marked_atoms[i]];
+                if(op_ind < 0 || op_marked[op_ind]) //true in the state or already in the relaxed plan
+                {
+                    continue;
+                }
+                op_marked[op_ind] = 1;
+                plan.push_back(op_ind);
+                for(int atom_id : (*operators)[op_ind].pre)
+                {
+                    if(!atom_marked[atom_id])
+                    {
+                        atom_marked[atom_id] = 1;
+                        marked_atoms.push_back(atom_id);
+                    }
+                }
+            }
+
+            for(int atom_id : marked_atoms)
+            {
+                atom_marked[atom_id] = 0;
+            }
+            for(int op_ind : plan)
+            {
+                op_marked[op_ind] = 0;
+                if(helpful != nullptr && state.contains_all((*operators)[op_ind].pre_mask))
+                {
+                    helpful->push_back(op_ind);
+                }
+            }
+            return plan.size(); //assumes that all actions have equal cost
+        }
+};
+
+//pairwise mutexes of the grounded task from the h^2 fixpoint. A pair of atoms is reachable if both hold in the start,
+//or if an operator whose preconditions are pairwise reachable adds one of them and either adds the other or leaves it
+//untouched while it is reachable together with every precondition. Pairs that never become reachable are never true
+//together in a reachable state. The table takes num_atoms^2 bits, above MAX_ATOMS it is not built and every state
+//counts as consistent
+class pair_mutexes
+{
+    private:
+        static const int MAX_ATOMS = 8192; //8 MB of pair bits
+        int num_words = 0;
+        vector<uint64_t> rows; //atom p -> bitset of the atoms q such that {p, q} is reachable, {p, p} stands for p alone
+
+        uint64_t* row(int atom_id)
+        {
+            return &rows[atom_id * num_words];
+        }
+
+        const uint64_t* row(int atom_id) const
+        {
+            return &rows[atom_id * num_words];
+        }
+
+        bool reached(int p, int q) const
+        {
+            return (row(p)[q >> 6] >> (q & 63)) & 1ULL;
+        }
+
+        //marks {p, q} reachable, returns false if it already was
+        bool reach(int p, int q)
+        {
+            if(reached(p, q))
+            {
+                return false;
+            }
+            row(p)[q >> 6] |= 1ULL << (q & 63);
+            row(q)[p >> 6] |= 1ULL << (p & 63);
+            return true;
+        }
+
+    public:
+        //returns false if the task has too many atoms for the pair table
+        bool init(const vector<ground_operator>& operators, int num_atoms, const state_view& start)
+        {
+            rows.clear();
+            num_words = 0;
+            if(num_atoms > MAX_ATOMS)
+            {
+                return false;
+            }
+            num_words = (num_atoms + 63) / 64;
+            rows.assign(num_atoms * num_words, 0);
+            for(int p = 0; p < num_atoms; p++)
+            {
+                if(start.test(p))
+                {
+                    for(int w = 0; w < num_words; w++)
+                    {
+                        row(p)[w] = start.word(w);
+                    }
+                }
+            }
+
+            vector<uint64_t> alone(num_words); //atoms reachable on their own
+            vector<uint64_t> with_pre(num_words); //atoms reachable together with every precondition of the operator
+            bool changed = true;
+            while(changed)
+            {
+                changed = false;
+                for(int p = 0; p < num_atoms; p++)
+                {
+                    if(reached(p, p))
+                    {
+                        alone[p >> 6] |= 1ULL << (p & 63);
+                    }
+                }
+                for(const ground_operator& op : operators)
+                {
+                    with_pre = alone;
+                    for(int r : op.pre)
+                    {
+                        for(int w = 0; w < num_words; w++)
+                        {
+                            with_pre[w] &= row(r)[w];
+                        }
+                    }
+                    bool applicable = true;
+                    for(int r : op.pre)
+                    {
+                        applicable &= (with_pre[r >> 6] >> (r & 63)) & 1ULL;
+                    }
+                    if(!applicable) //a precondition is not reachable together with all the others
+                    {
+                        continue;
+                    }
+                    for(int w = 0; w < num_words; w++)
+                    {
+                        with_pre[w] &= ~(op.del_mask.word(w) | op.add_mask.word(w));
+                    }
+                    for(int p : op.add)
+                    {
+                        for(int q : op.add)
+                        {
+                            changed |= reach(p, q);
+                        }
+                        for(int w = 0; w < num_words; w++)
+                        {
+                            for(uint64_t word = with_pre[w] & ~row(p)[w]; word != 0; word &= word - 1)
+                            {
+                                changed |= reach(p, (w << 6) + lowest_bit64(word));
+                            }
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        //false if the (partial) state holds an unreachable atom or a mutex pair, no reachable state contains it then
+        bool consistent(const state_view& state) const
+        {
+            if(rows.empty())
+            {
+                return true;
+            }
+            for(int i = 0; i < state.num_words(); i++)
+            {
+                for(uint64_t word = state.word(i); word != 0; word &= word - 1)
+                {
+                    if(!state_view(row((i << 6) + lowest_bit64(word)), num_words).contains_all(state))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        int num_mutexes() const
+        {
+            int count = 0;
+            int num_atoms = num_words == 0 ? 0 : rows.size() / num_words;
+            for(int p = 0; p < num_atoms; p++)
+            {
+                for(int q = p + 1; q < num_atoms; q++)
+                {
+                    count += reached(p, p) && reached(q, q) && !reached(p, q);
+                }
+            }
+            return count;
+        }
+};
+
+typedef uint32_t state_id;
+const state_id NO_STATE = 0xFFFFFFFF;
+
+//finite-domain (SAS+) encoding of states for storage. Every group of mutually exclusive atoms becomes one variable whose
+//value is the index of its true atom, or the group size if none is (left out for exactly-one groups). Atoms outside the
+//groups are binary variables. A variable takes ceil(log2(domain)) bits and its field never straddles a word
+class state_packer
+{
+    private:
+        struct variable
+        {
+            int word;
+            int shift;
+            uint64_t mask; //unshifted field mask
+            vector<int> atoms; //value -> atom id
+        };
+        vector<variable> variables;
+        vector<int> variable_of; //atom id -> variable
+        vector<int> value_of; //atom id -> value
+        vector<uint64_t> none_words; //packed state in which every variable holds its "no atom" value
+        int words = 0;
+        int unpacked_words = 0;
+        int total_bits = 0;
+
+    public:
+        //groups must be disjoint, atoms of no group become binary variables
+        void init(const vector<vector<int>>& groups, const vector<uint8_t>& exactly_one, int num_atoms)
+        {
+            variables.clear();
+            variable_of.assign(num_atoms, -1);
+            value_of.assign(num_atoms, 0);
+            vector<int> none_values;
+            auto add_variable = [&](const vector<int>& atoms, bool has_none)
+            {
+                int domain = atoms.size() + (has_none ? 1 : 0);
+                int bits = 0;
+                while((1 << bits) < domain)
+                {
+                    bits++;
+                }
+                variable var;
+                var.word = total_bits >> 6;
+                var.shift = total_bits & 63;
+                if(var.shift + bits > 64)
+                {
+                    var.word++;
+                    var.shift = 0;
+                }
+                var.mask = (bits == 64) ? ~0ULL : (1ULL << bits) - 1;
+                var.atoms = atoms;
+                total_bits = var.word * 64 + var.shift + bits;
+                for(int value = 0; value < atoms.size(); value++)
+                {
+                    variable_of[atoms[value]] = variables.size();
+                    value_of[atoms[value]] = value;
+                }
+                none_values.push_back(has_none ? atoms.size() : 0);
+                variables.push_back(var);
+            };
+            total_bits = 0;
+            for(int i = 0; i < groups.size(); i++)
+            {
+                add_variable(groups[i], !exactly_one[i]);
+            }
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                if(variable_of[atom_id] < 0)
+                {
+                    add_variable(vector<int>(1, atom_id), true);
+                }
+            }
+            words = max((total_bits + 63) >> 6, 1);
+            unpacked_words = (num_atoms + 63) >> 6;
+            none_words.assign(words, 0);
+            for(int v = 0; v < variables.size(); v++)
+            {
+                none_words[variables[v].word] |= (uint64_t)none_values[v] << variables[v].shift;
+            }
+        }
+
+        //State is a state_view or a successor_delta over the unpacked atoms
+        template<typename State>
+        void pack(const State& state, uint64_t* out) const
+        {
+            copy(none_words.begin(), none_words.end(), out);
+            for(int i = 0; i < unpacked_words; i++)
+            {
+                for(uint64_t word = state.word(i); word != 0; word &= word - 1)
+                {
+                    int atom_id = (i << 6) + lowest_bit64(word);
+                    const variable& var = variables[variable_of[atom_id]];
+                    out[var.word] = (out[var.word] & ~(var.mask << var.shift)) | ((uint64_t)value_of[atom_id] << var.shift);
+                }
+            }
+        }
+
+        void unpack(const uint64_t* packed, uint64_t* out) const
+        {
+            fill(out, out + unpacked_words, 0);
+            for(const variable& var : variables)
+            {
+                uint64_t value = (packed[var.word] >> var.shift) & var.mask;
+                if(value < var.atoms.size())
+                {
+                    int atom_id = var.atoms[value];
+                    out[atom_id >> 6] |= 1ULL << (atom_id & 63);
+                }
+            }
+        }
+
+        int packed_words() const
+        {
+            return words;
+        }
+
+        int num_variables() const
+        {
+            return variables.size();
+        }
+
+        int bits() const
+        {
+            return total_bits;
+        }
+};
+
+//interns packed states and hands out dense 32-bit ids. Each state's words are stored once, in fixed-size chunks
+//carved from a search arena (so the pool never moves or gets copied while it grows), and found again through
+//an open-addressing table of ids keyed by the state's zobrist hash. Given a state_packer the words stored are the
+//finite-domain encoding, looked up states are decoded into a buffer owned by the caller
+class state_registry
+{
+    private:
+        int num_words = 0; //stored words per state
+        int state_words = 0; //words of an unpacked state
+        const state_packer* packer = nullptr;
+        int chunk_shift = 0; //states per chunk = 1 << chunk_shift
+        search_arena arena;
+        vector<uint64_t*> chunks;
+        vector<uint64_t> hashes; //zobrist hash per state id
+        vector<state_id> table; //NO_STATE marks an empty slot, size is a power of two
+        int count = 0;
+
+        uint64_t* words_of(state_id id) const
+        {
+            return chunks[id >> chunk_shift] + (size_t)(id & ((1u << chunk_shift) - 1)) * num_words;
+        }
+
+        void place(state_id id)
+        {
+            size_t mask = table.size() - 1;
+            size_t slot = hashes[id] & mask;
+            while(table[slot] != NO_STATE)
+            {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = id;
+        }
+
+        static void write_state(uint64_t* out, const state_view& state)
+        {
+            memcpy(out, state.data(), state.num_words() * sizeof(uint64_t));
+        }
+
+        static void write_state(uint64_t* out, const successor_delta& state)
+        {
+            state.materialize(out);
+        }
+
+        void grow_table()
+        {
+            table.assign(table.empty() ? 1024 : table.size() * 2, NO_STATE);
+            for(state_id id = 0; id < count; id++)
+            {
+                place(id);
+            }
+        }
+
+    public:
+        state_registry()
+        {
+            //do nothing
+        }
+
+        //registries are never shared: a copy starts out empty with the same state layout
+        state_registry(const state_registry& other)
+        {
+            init(other.state_words, other.packer);
+        }
+
+        state_registry& operator=(const state_registry& other)
+        {
+            if(this != &other)
+            {
+                clear();
+                init(other.state_words, other.packer);
+            }
+            return *this;
+        }
+
+        void init(int num_words_in, const state_packer* packer_in = nullptr)
+        {
+            state_words = num_words_in;
+            packer = packer_in;
+            num_words = (packer != nullptr) ? packer->packed_words() : state_words;
+            chunk_shift = 0;
+            while(((size_t)num_words * sizeof(uint64_t) << (chunk_shift + 1)) <= (1 << 16)) //~64KB of state words per chunk
+            {
+                chunk_shift++;
+            }
+        }
+
+        //view valid for as long as buffer is left alone (or, unpacked, as long as the registry). A packed state is
+        //decoded into buffer, so lookups sharing a buffer must not overlap
+        state_view lookup_state(state_id id, vector<uint64_t>& buffer) const
+        {
+            if(packer == nullptr)
+            {
+                return state_view(words_of(id), num_words);
+            }
+            buffer.resize(state_words);
+            packer->unpack(words_of(id), buffer.data());
+            return state_view(buffer.data(), state_words);
+        }
+
+        uint64_t get_hash(state_id id) const
+        {
+            return hashes[id];
+        }
+
+        //returns NO_STATE if the state was never registered. State is a state_view or a successor_delta
+        template<typename State>
+        state_id find(const State& state, uint64_t hash) const
+        {
+            if(table.empty())
+            {
+                return NO_STATE;
+            }
+            size_t mask = table.size() - 1;
+            if(packer != nullptr) //compared in the encoding, the search may be probing from several threads
+            {
+                static thread_local vector<uint64_t> packed;
+                packed.resize(num_words);
+                packer->pack(state, packed.data());
+                for(size_t slot = hash & mask; table[slot] != NO_STATE; slot = (slot + 1) & mask)
+                {
+                    state_id id = table[slot];
+                    if(hashes[id] == hash && memcmp(words_of(id), packed.data(), num_words * sizeof(uint64_t)) == 0)
+                    {
+                        return id;
+                    }
+                }
+                return NO_STATE;
+            }
+            for(size_t slot = hash & mask; table[slot] != NO_STATE; slot = (slot + 1) & mask)
+            {
+                state_id id = table[slot];
+                if(hashes[id] == hash && state == state_view(words_of(id), num_words))
+                {
+                    return id;
+                }
+            }
+            return NO_STATE;
+        }
+
+        //returns the id of the state and whether it was newly registered, a delta is only materialized if it is new
+        template<typename State>
+        pair<state_id, bool> insert(const State& state, uint64_t hash)
+        {
+            state_id existing = find(state, hash);
+            if(existing != NO_STATE)
+            {
+                return {existing, false};
+            }
+            state_id id = count++;
+            if((id >> chunk_shift) == chunks.size())
+            {
+                chunks.push_back(arena.allocate_words(num_words << chunk_shift));
+            }
+            if(packer != nullptr)
+            {
+                packer->pack(state, words_of(id));
+            }
+            else
+            {
+                write_state(words_of(id), state);
+            }
+            hashes.push_back(hash);
+            if(2 * (size_t)count > table.size()) //keeps the load factor at or below 1/2
+            {
+                grow_table();
+            }
+            else
+            {
+                place(id);
+            }
+            return {id, true};
+        }
+
+        int size() const
+        {
+            return count;
+        }
+
+        size_t memory_bytes() const
+        {
+            return chunks.size() * ((size_t)num_words * sizeof(uint64_t) << chunk_shift) 
+                + hashes.capacity() * sizeof(uint64_t) + table.capacity() * sizeof(state_id);
+        }
+
+        //forgets every state, all ids and views handed out become invalid
+        void clear()
+        {
+            arena.release();
+            chunks.clear();
+            hashes.clear();
+            hashes.shrink_to_fit();
+            table.clear();
+            table.shrink_to_fit();
+            count = 0;
+        }
+};
+
+//per-state search data, one flat array per field indexed by state_id
+struct search_info
+{
+    vector<int> g; //best g found so far, set when the state is generated
+    vector<int> h; //heuristic estimate, -1 until evaluated
+    vector<state_id> parent;
+    vector<int> creating_op; //-1 for the start state
+    vector<uint8_t> closed;
+
+    //makes room for newly registered states
+    void resize(int num_states)
+    {
+        g.resize(num_states, INT32_MAX);
+        h.resize(num_states, -1);
+        parent.resize(num_states, NO_STATE);
+        creating_op.resize(num_states, -1);
+        closed.resize(num_states, 0);
+    }
+
+    size_t memory_bytes() const
+    {
+        return g.capacity() * sizeof(int) + h.capacity() * sizeof(int) + parent.capacity() * sizeof(state_id) 
+            + creating_op.capacity() * sizeof(int) + closed.capacity();
+    }
+
+    void clear()
+    {
+        g = vector<int>();
+        h = vector<int>();
+        parent = vector<state_id>();
+        creating_op = vector<int>();
+        closed = vector<uint8_t>();
+    }
+};
+
+//fact landmarks of the grounded task: atoms that are true at some point of every plan. Found by backchaining from
+//the goals, the preconditions shared by every possible first achiever of a landmark are landmarks as well and are
+//greedy-necessarily ordered before it. The per-state accepted sets of the landmark-count heuristic live here too,
+//one bitset per state id in a single flat array
+class landmark_graph
+{
+    private:
+        const vector<ground_operator>* operators = nullptr;
+        int num_atoms = 0;
+        vector<int> landmarks; //atom id of every landmark
+        vector<int> landmark_of; //atom id -> landmark index, -1 if the atom is no landmark
+        vector<vector<int>> predecessors; //landmark -> landmarks greedy-necessarily ordered before it
+        vector<vector<int>> successors; //inverse of predecessors
+        vector<uint8_t> is_goal;
+        int num_orderings = 0;
+
+        int words = 0; //bitset words per state
+        vector<uint64_t> accepted; //accepted landmarks, words per state id
+
+        int add_landmark(int atom_id)
+        {
+            if(landmark_of[atom_id] < 0)
+            {
+                landmark_of[atom_id] = landmarks.size();
+                landmarks.push_back(atom_id);
+                predecessors.push_back(vector<int>());
+                successors.push_back(vector<int>());
+            }
+            return landmark_of[atom_id];
+        }
+
+        //atoms reachable from init under the delete relaxation without using any operator that adds excluded
+        void reachable_without(const state_view& init, int excluded, const vector<vector<int>>& precondition_of, vector<uint8_t>& reached)
+        {
+            const vector<ground_operator>& ops = *operators;
+            vector<int> unsatisfied(ops.size());
+            vector<int> queue;
+            reached.assign(num_atoms, 0);
+            for(int op_ind = 0; op_ind < ops.size(); op_ind++)
+            {
+                unsatisfied[op_ind] = ops[op_ind].pre.size();
+            }
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                if(init.test(atom_id))
+                {
+                    reached[atom_id] = 1;
+                    queue.push_back(atom_id);
+                }
+            }
+            auto fire = [&](int op_ind)
+            {
+                if(ops[op_ind].add_mask.test(excluded))
+                {
+                    return;
+                }
+                for(int added : ops[op_ind].add)
+                {
+                    if(!reached[added])
+                    {
+                        reached[added] = 1;
+                        queue.push_back(added);
+                    }
+                }
+            };
+            for(int op_ind = 0; op_ind < ops.size(); op_ind++)
+            {
+                if(ops[op_ind].pre.empty())
+                {
+                    fire(op_ind);
+                }
+            }
+            for(int i = 0; i < queue.size(); i++)
+            {
+                for(int op_ind : precondition_of[queue[i]])
+                {
+                    if(--unsatisfied[op_ind] == 0)
+                    {
+                        fire(op_ind);
+                    }
+                }
+            }
+        }
+
+        bool is_accepted(const uint64_t* bits, int lm) const
+        {
+            return (bits[lm >> 6] >> (lm & 63)) & 1;
+        }
+
+    public:
+        void discover(const vector<ground_operator>& operators_in, int num_atoms_in, const state_view& init, const state_view& goal)
+        {
+            operators = &operators_in;
+            num_atoms = num_atoms_in;
+            landmarks.clear();
+            predecessors.clear();
+            successors.clear();
+            num_orderings = 0;
+            landmark_of.assign(num_atoms, -1);
+            is_goal.clear();
+
+            vector<vector<int>> achievers(num_atoms);
+            vector<vector<int>> precondition_of(num_atoms);
+            for(int op_ind = 0; op_ind < operators_in.size(); op_ind++)
+            {
+                for(int atom_id : operators_in[op_ind].add)
+                {
+                    achievers[atom_id].push_back(op_ind);
+                }
+                for(int atom_id : operators_in[op_ind].pre)
+                {
+                    precondition_of[atom_id].push_back(op_ind);
+                }
+            }
+
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                if(goal.test(atom_id))
+                {
+                    add_landmark(atom_id);
+                }
+            }
+            vector<uint8_t> reached;
+            for(int lm = 0; lm < landmarks.size(); lm++) //landmarks grows while it is traversed
+            {
+                int atom_id = landmarks[lm];
+                if(init.test(atom_id))
+                {
+                    continue;
+                }
+                //possible first achievers: achievers applicable before the landmark can have been reached
+                reachable_without(init, atom_id, precondition_of, reached);
+                vector<int> shared;
+                bool first = true;
+                for(int op_ind : achievers[atom_id])
+                {
+                    const vector<int>& pre = operators_in[op_ind].pre;
+                    if(!all_of(pre.begin(), pre.end(), [&](int p) { return reached[p]; }))
+                    {
+                        continue;
+                    }
+                    if(first)
+                    {
+                        shared = pre;
+                        first = false;
+                    }
+                    else
+                    {
+                        const state_bits& mask = operators_in[op_ind].pre_mask;
+                        shared.erase(remove_if(shared.begin(), shared.end(), [&](int p) { return !mask.test(p); }), shared.end());
+                    }
+                }
+                for(int pre_atom : shared)
+                {
+                    int before = add_landmark(pre_atom);
+                    predecessors[lm].push_back(before);
+                    successors[before].push_back(lm);
+                    num_orderings++;
+                }
+            }
+
+            is_goal.assign(landmarks.size(), 0);
+            for(int lm = 0; lm < landmarks.size(); lm++)
+            {
+                is_goal[lm] = goal.test(landmarks[lm]);
+            }
+            words = (landmarks.size() + 63) / 64;
+        }
+
+        int size() const
+        {
+            return landmarks.size();
+        }
+
+        int orderings() const
+        {
+            return num_orderings;
+        }
+
+        //accepted set of the start state: its true landmarks that nothing has to precede
+        void init_start(state_id start, const state_view& state)
+        {
+            accepted.assign((start + 1) * words, 0);
+            uint64_t* bits = accepted.data() + start * words;
+            for(int lm = 0; lm < landmarks.size(); lm++)
+            {
+                if(predecessors[lm].empty() && state.test(landmarks[lm]))
+                {
+                    bits[lm >> 6] |= 1ULL << (lm & 63);
+                }
+            }
+        }
+
+        //accepts the landmarks that became true in child with all their predecessors accepted in parent.
+        //A state reached again keeps only the landmarks accepted along both paths, returns true if its set changed
+        bool progress(state_id parent, state_id child, const state_view& child_state, bool first_reach)
+        {
+            if(accepted.size() < (child + 1) * words)
+            {
+                accepted.resize((child + 1) * words, 0);
+            }
+            const uint64_t* parent_bits = accepted.data() + parent * words;
+            uint64_t* child_bits = accepted.data() + child * words;
+            bool changed = first_reach;
+            for(int w = 0; w < words; w++)
+            {
+                uint64_t reached_now = parent_bits[w];
+                for(int lm = w * 64; lm < min((w + 1) * 64, size()); lm++)
+                {
+                    if(!is_accepted(parent_bits, lm) && child_state.test(landmarks[lm]) 
+                        && all_of(predecessors[lm].begin(), predecessors[lm].end(), [&](int p) { return is_accepted(parent_bits, p); }))
+                    {
+                        reached_now |= 1ULL << (lm & 63);
+                    }
+                }
+                uint64_t merged = first_reach ? reached_now : (child_bits[w] & reached_now);
+                changed = changed || merged != child_bits[w];
+                child_bits[w] = merged;
+            }
+            return changed;
+        }
+
+        //landmark-count heuristic: landmarks not yet accepted, plus accepted ones that are false again but still
+        //required (a goal, or greedy-necessarily needed for a landmark that is not accepted yet)
+        int count(state_id id, const state_view& state) const
+        {
+            const uint64_t* bits = accepted.data() + id * words;
+            int h = 0;
+            for(int lm = 0; lm < landmarks.size(); lm++)
+            {
+                if(!is_accepted(bits, lm))
+                {
+                    h++;
+                }
+                else if(!state.test(landmarks[lm]))
+                {
+                    if(is_goal[lm] || any_of(successors[lm].begin(), successors[lm].end(), [&](int next) { return !is_accepted(bits, next); }))
+                    {
+                        h++;
+                    }
+                }
+            }
+            return h;
+        }
+
+        size_t memory_bytes() const
+        {
+            return accepted.capacity() * sizeof(uint64_t);
+        }
+
+        void clear()
+        {
+            accepted = vector<uint64_t>();
+        }
+};
+
+//projection of the task onto a small set of atoms. Abstract states are bitmasks over the pattern positions, which
+//doubles as their perfect hash, and their goal distances are found once by a backward breadth-first search
+class pattern_database
+{
+    private:
+        vector<int> pattern; //atom ids, bit i of an abstract state is pattern[i]
+        vector<uint16_t> distances; //indexed by abstract state
+        static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+        struct abstract_operator
+        {
+            uint32_t pre, effect, add; //effect covers added and deleted positions
+        };
+
+    public:
+        void build(const vector<ground_operator>& operators, const vector<int>& pattern_in, const state_view& goal)
+        {
+            pattern = pattern_in;
+            unordered_map<int, int> position;
+            for(int i = 0; i < pattern.size(); i++)
+            {
+                position[pattern[i]] = i;
+            }
+            auto project = [&](const vector<int>& atoms)
+            {
+                uint32_t mask = 0;
+                for(int atom_id : atoms)
+                {
+                    auto it = position.find(atom_id);
+                    if(it != position.end())
+                    {
+                        mask |= 1u << it->second;
+                    }
+                }
+                return mask;
+            };
+
+            vector<abstract_operator> abstract_ops;
+            for(const ground_operator& op : operators)
+            {
+                abstract_operator projected{project(op.pre), project(op.add) | project(op.del), project(op.add)};
+                if(projected.effect != 0) //operators leaving the pattern untouched are self loops
+                {
+                    abstract_ops.push_back(projected);
+                }
+            }
+
+            uint32_t num_states = 1u << pattern.size();
+            uint32_t goal_mask = 0;
+            for(int i = 0; i < pattern.size(); i++)
+            {
+                if(goal.test(pattern[i]))
+                {
+                    goal_mask |= 1u << i;
+                }
+            }
+            distances.assign(num_states, UNREACHABLE);
+            vector<uint32_t> queue;
+            for(uint32_t abstract = 0; abstract < num_states; abstract++)
+            {
+                if((abstract & goal_mask) == goal_mask)
+                {
+                    distances[abstract] = 0;
+                    queue.push_back(abstract);
+                }
+            }
+            //regression: a predecessor agrees with the target outside the effect, holds the precondition and is free
+            //on effect positions the precondition does not fix
+            for(int i = 0; i < queue.size(); i++)
+            {
+                uint32_t target = queue[i];
+                for(const abstract_operator& op : abstract_ops)
+                {
+                    uint32_t deleted = op.effect & ~op.add;
+                    uint32_t kept_pre = op.pre & ~op.effect;
+                    if((target & op.add) != op.add || (target & deleted) != 0 || (target & kept_pre) != kept_pre)
+                    {
+                        continue;
+                    }
+                    uint32_t base = (target & ~op.effect) | op.pre;
+                    uint32_t free = op.effect & ~op.pre;
+                    for(uint32_t sub = free; ; sub = (sub - 1) & free) //every subset of the free positions
+                    {
+                        uint32_t pred = base | sub;
+                        if(distances[pred] == UNREACHABLE)
+                        {
+                            distances[pred] = distances[target] + 1; //assumes that all actions have equal cost
+                            queue.push_back(pred);
+                        }
+                        if(sub == 0)
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        int lookup(const state_view& state) const
+        {
+            uint32_t abstract = 0;
+            for(int i = 0; i < pattern.size(); i++)
+            {
+                abstract |= (uint32_t)state.test(pattern[i]) << i;
+            }
+            return distances[abstract] == UNREACHABLE ? DEAD_END : distances[abstract];
+        }
+
+        const vector<int>& get_pattern() const
+        {
+            return pattern;
+        }
+
+        size_t memory_bytes() const
+        {
+            return distances.capacity() * sizeof(uint16_t);
+        }
+};
+
+//pattern collection built at startup: one pattern per goal atom, grown backwards through the preconditions of its
+//achievers without reusing atoms of earlier patterns. Patterns no operator affects together are summed, the
+//heuristic is the maximum over these additive groups so it stays admissible
+class pdb_collection
+{
+    private:
+        vector<pattern_database> pdbs;
+        vector<vector<int>> additive_groups; //indices into pdbs
+
+    public:
+        void build(const vector<ground_operator>& operators, int num_atoms, const state_view& goal, int max_pattern_size)
+        {
+            pdbs.clear();
+            additive_groups.clear();
+            vector<vector<int>> achievers(num_atoms);
+            for(int op_ind = 0; op_ind < operators.size(); op_ind++)
+            {
+                for(int atom_id : operators[op_ind].add)
+                {
+                    achievers[atom_id].push_back(op_ind);
+                }
+            }
+
+            vector<uint8_t> used(num_atoms, 0);
+            for(int goal_atom = 0; goal_atom < num_atoms; goal_atom++)
+            {
+                if(!goal.test(goal_atom) || used[goal_atom])
+                {
+                    continue;
+                }
+                vector<int> pattern = {goal_atom};
+                used[goal_atom] = 1;
+                for(int i = 0; i < pattern.size() && pattern.size() < max_pattern_size; i++)
+                {
+                    for(int op_ind : achievers[pattern[i]])
+                    {
+                        for(int atom_id : operators[op_ind].pre)
+                        {
+                            if(!used[atom_id] && pattern.size() < max_pattern_size)
+                            {
+                                used[atom_id] = 1;
+                                pattern.push_back(atom_id);
+                            }
+                        }
+                    }
+                }
+                pdbs.push_back(pattern_database());
+                pdbs.back().build(operators, pattern, goal);
+            }
+
+            //operator -> patterns it affects, two patterns are additive if no operator affects both
+            vector<int> pattern_of(num_atoms, -1);
+            for(int i = 0; i < pdbs.size(); i++)
+            {
+                for(int atom_id : pdbs[i].get_pattern())
+                {
+                    pattern_of[atom_id] = i;
+                }
+            }
+            vector<vector<uint8_t>> interfering(pdbs.size(), vector<uint8_t>(pdbs.size(), 0));
+            for(const ground_operator& op : operators)
+            {
+                vector<int> affected;
+                for(const vector<int>* effects : {&op.add, &op.del})
+                {
+                    for(int atom_id : *effects)
+                    {
+                        if(pattern_of[atom_id] >= 0)
+                        {
+                            affected.push_back(pattern_of[atom_id]);
+                        }
+                    }
+                }
+                for(int a : affected)
+                {
+                    for(int b : affected)
+                    {
+                        interfering[a][b] |= (a != b);
+                    }
+                }
+            }
+            for(int i = 0; i < pdbs.size(); i++)
+            {
+                bool placed = false;
+                for(vector<int>& group : additive_groups)
+                {
+                    if(none_of(group.begin(), group.end(), [&](int j) { return interfering[i][j]; }))
+                    {
+                        group.push_back(i);
+                        placed = true;
+                        break;
+                    }
+                }
+                if(!placed)
+                {
+                    additive_groups.push_back({i});
+                }
+            }
+        }
+
+        int evaluate(const state_view& state) const
+        {
+            int h = 0;
+            for(const vector<int>& group : additive_groups)
+            {
+                int sum = 0;
+                for(int i : group)
+                {
+                    int value = pdbs[i].lookup(state);
+                    if(value == DEAD_END)
+                    {
+                        return DEAD_END;
+                    }
+                    sum += value;
+                }
+                h = max(h, sum);
+            }
+            return h;
+        }
+
+        int size() const
+        {
+            return pdbs.size();
+        }
+
+        int num_groups() const
+        {
+            return additive_groups.size();
+        }
+
+        size_t memory_bytes() const
+        {
+            size_t bytes = 0;
+            for(const pattern_database& pdb : pdbs)
+            {
+                bytes += pdb.memory_bytes();
+            }
+            return bytes;
+        }
+};
+
+//strong stubborn sets for partial-order reduction. Starting from the achievers of a goal atom the state lacks, the set
+//is closed under two rules: an inapplicable member adds the achievers of one of its unsatisfied preconditions, an
+//applicable member adds every operator it interferes with. Only applicable members need to be expanded, which keeps
+//every plan (and every optimal one) up to the order of independent operators
+class stubborn_sets
+{
+    private:
+        const vector<ground_operator>* operators = nullptr;
+        vector<vector<int>> achievers; //atom -> operators adding it
+        vector<vector<int>> interfering; //operator -> operators it disables, is disabled by or has conflicting effects with
+        vector<int> goal_atoms;
+        int num_pairs = 0;
+
+        //scratch reused by every call
+        vector<uint8_t> in_set;
+        vector<int> members; //the stubborn set in insertion order, doubles as the worklist
+
+        int applicable_count = 0;
+        int pruned_count = 0;
+
+        void add_achievers(int atom_id)
+        {
+            for(int op_ind : achievers[atom_id])
+            {
+                if(!in_set[op_ind])
+                {
+                    in_set[op_ind] = 1;
+                    members.push_back(op_ind);
+                }
+            }
+        }
+
+        //the atom of atoms that state lacks with the fewest achievers, -1 if state has all of them
+        int cheapest_missing(const state_view& state, const vector<int>& atoms) const
+        {
+            int best = -1;
+            for(int atom_id : atoms)
+            {
+                if(!state.test(atom_id) && (best < 0 || achievers[atom_id].size() < achievers[best].size()))
+                {
+                    best = atom_id;
+                }
+            }
+            return best;
+        }
+
+    public:
+        void init(const vector<ground_operator>& operators_in, int num_atoms, const state_view& goal)
+        {
+            operators = &operators_in;
+            achievers.assign(num_atoms, vector<int>());
+            vector<vector<int>> deleters(num_atoms);
+            vector<vector<int>> precondition_of(num_atoms);
+            for(int op_ind = 0; op_ind < operators_in.size(); op_ind++)
+            {
+                const ground_operator& op = operators_in[op_ind];
+                for(int atom_id : op.add)
+                {
+                    achievers[atom_id].push_back(op_ind);
+                }
+                for(int atom_id : op.del)
+                {
+                    if(!op.add_mask.test(atom_id)) //adds win over deletes, such an atom is never deleted
+                    {
+                        deleters[atom_id].push_back(op_ind);
+                    }
+                }
+                for(int atom_id : op.pre)
+                {
+                    precondition_of[atom_id].push_back(op_ind);
+                }
+            }
+            goal_atoms.clear();
+            for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+            {
+                if(goal.test(atom_id))
+                {
+                    goal_atoms.push_back(atom_id);
+                }
+            }
+
+            interfering.assign(operators_in.size(), vector<int>());
+            vector<int> stamp(operators_in.size(), -1);
+            num_pairs = 0;
+            for(int op_ind = 0; op_ind < operators_in.size(); op_ind++)
+            {
+                const ground_operator& op = operators_in[op_ind];
+                vector<int>& result = interfering[op_ind];
+                stamp[op_ind] = op_ind;
+                auto collect = [&](const vector<int>& candidates)
+                {
+                    for(int other : candidates)
+                    {
+                        if(stamp[other] != op_ind)
+                        {
+                            stamp[other] = op_ind;
+                            result.push_back(other);
+                        }
+                    }
+                };
+                for(int atom_id : op.del)
+                {
+                    if(!op.add_mask.test(atom_id))
+                    {
+                        collect(precondition_of[atom_id]); //op disables them
+                        collect(achievers[atom_id]); //conflicting effects
+                    }
+                }
+                for(int atom_id : op.pre)
+                {
+                    collect(deleters[atom_id]); //they disable op
+                }
+                for(int atom_id : op.add)
+                {
+                    collect(deleters[atom_id]);
+                }
+                num_pairs += result.size();
+            }
+            in_set.assign(operators_in.size(), 0);
+            members.clear();
+            applicable_count = 0;
+            pruned_count = 0;
+        }
+
+        //drops the operators outside a strong stubborn set of state from applicable, keeping the order of the rest.
+        //Goal states are left alone
+        void prune(const state_view& state, vector<int>& applicable)
+        {
+            applicable_count += applicable.size();
+            int goal_atom = cheapest_missing(state, goal_atoms);
+            if(goal_atom < 0)
+            {
+                return;
+            }
+            add_achievers(goal_atom);
+            for(int i = 0; i < members.size(); i++)
+            {
+                const ground_operator& op = (*operators)[members[i]];
+                int missing = cheapest_missing(state, op.pre);
+                if(missing >= 0)
+                {
+                    add_achievers(missing);
+                    continue;
+                }
+                for(int other : interfering[members[i]])
+                {
+                    if(!in_set[other])
+                    {
+                        in_set[other] = 1;
+                        members.push_back(other);
+                    }
+                }
+            }
+            int kept = 0;
+            for(int op_ind : applicable)
+            {
+                if(in_set[op_ind])
+                {
+                    applicable[kept++] = op_ind;
+                }
+            }
+            pruned_count += applicable.size() - kept;
+            applicable.resize(kept);
+            for(int op_ind : members)
+            {
+                in_set[op_ind] = 0;
+            }
+            members.clear();
+        }
+
+        //pairs of interfering operators, each pair counted from both sides
+        int interference_pairs() const
+        {
+            return num_pairs;
+        }
+
+        int applicable_seen() const
+        {
+            return applicable_count;
+        }
+
+        int pruned() const
+        {
+            return pruned_count;
+        }
+
+        void add_counts(const stubborn_sets& other)
+        {
+            applicable_count += other.applicable_count;
+            pruned_count += other.pruned_count;
+        }
+
+        void reset_counts()
+        {
+            applicable_count = 0;
+            pruned_count = 0;
+        }
+};
+
+//object symmetries of the grounded task: transpositions of two objects that map the initial state (static atoms
+//included) and the goal onto themselves. Action schemas only name objects through their constants, which stay fixed,
+//so every such transposition maps operators to operators. Candidate pairs come from colour refinement of the graph
+//linking each initial and goal atom (coloured by its predicate and role) to its argument objects, and every candidate
+//is verified before it becomes a generator. A state is reduced to a representative by applying generators for as
+//long as one makes it lexicographically smaller
+class object_symmetries
+{
+    private:
+        vector<pair<int, int>> swaps; //symbol pair of every generator
+        vector<vector<int>> atom_maps; //generator -> atom id -> image atom id
+
+        static Atom swapped(const Atom& atom, int a, int b)
+        {
+            Atom result = atom;
+            for(int i = 0; i < result.arity; i++)
+            {
+                if(result.args[i] == a)
+                {
+                    result.args[i] = b;
+                }
+                else if(result.args[i] == b)
+                {
+                    result.args[i] = a;
+                }
+            }
+            finalize_atom(result);
+            return result;
+        }
+
+        static int find_arg(const Atom& atom, int symbol)
+        {
+            for(int k = 0; k < atom.arity; k++)
+            {
+                if(atom.args[k] == symbol)
+                {
+                    return k;
+                }
+            }
+            return -1;
+        }
+
+        //true if the atoms map one to one onto the atoms of the mask
+        static bool maps_onto(const vector<int>& atoms, const vector<int>& image_atoms, const state_bits& image_mask, 
+            const vector<int>& atom_map)
+        {
+            if(atoms.size() != image_atoms.size())
+            {
+                return false;
+            }
+            for(int atom_id : atoms)
+            {
+                if(!image_mask.test(atom_map[atom_id]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+        //fixed: symbols that must map to themselves, the constants of the action schemas. A swap is only kept if it maps
+        //the start, the goal, the reachable atoms and the ground operators onto themselves
+        void detect(const vector<int>& symbols, const vector<int>& fixed, const vector<Atom>& init, const vector<Atom>& goal, 
+            const atom_index& index, const vector<ground_operator>& operators)
+        {
+            swaps.clear();
+            atom_maps.clear();
+            const vector<Atom>* roles[2] = {&init, &goal};
+            vector<vector<pair<int, int>>> touching(symbol_table.size()); //symbol -> (role, atom) having it as an argument
+            for(int role = 0; role < 2; role++)
+            {
+                for(int i = 0; i < roles[role]->size(); i++)
+                {
+                    const Atom& atom = (*roles[role])[i];
+                    for(int k = 0; k < atom.arity; k++)
+                    {
+                        if(k == 0 || find_arg(atom, atom.args[k]) == k) //once per atom
+                        {
+                            touching[atom.args[k]].push_back(make_pair(role, i));
+                        }
+                    }
+                }
+            }
+
+            //colour refinement: an object's next colour is its colour plus the sorted multiset of (role, predicate,
+            //argument colours, its positions) over the atoms it occurs in, until the number of colours is stable
+            vector<int> colour(symbol_table.size(), 0);
+            for(int i = 0; i < fixed.size(); i++)
+            {
+                colour[fixed[i]] = i + 1;
+            }
+            int num_colours = -1;
+            for(int round = 0; round <= symbols.size(); round++)
+            {
+                map<vector<int>, int> palette;
+                vector<int> next = colour;
+                for(int sym : symbols)
+                {
+                    vector<vector<int>> occurrences;
+                    for(const pair<int, int>& occurrence : touching[sym])
+                    {
+                        const Atom& atom = (*roles[occurrence.first])[occurrence.second];
+                        vector<int> entry{occurrence.first, atom.predicate};
+                        for(int k = 0; k < atom.arity; k++)
+                        {
+                            entry.push_back(atom.args[k] == sym ? -1 : colour[atom.args[k]]);
+                        }
+                        occurrences.push_back(entry);
+                    }
+                    sort(occurrences.begin(), occurrences.end());
+                    vector<int> signature{colour[sym]};
+                    for(const vector<int>& entry : occurrences)
+                    {
+                        signature.push_back(entry.size());
+                        signature.insert(signature.end(), entry.begin(), entry.end());
+                    }
+                    next[sym] = palette.emplace(signature, palette.size()).first->second;
+                }
+                colour = next;
+                if(palette.size() == num_colours)
+                {
+                    break;
+                }
+                num_colours = palette.size();
+            }
+
+            atom_set sets[2] = {atom_set(init.begin(), init.end()), atom_set(goal.begin(), goal.end())};
+            map<vector<int>, int> op_lookup; //(action, args...) -> ground operator
+            for(int op_ind = 0; op_ind < operators.size(); op_ind++)
+            {
+                vector<int> key{operators[op_ind].action};
+                key.insert(key.end(), operators[op_ind].args.begin(), operators[op_ind].args.end());
+                op_lookup[key] = op_ind;
+            }
+            for(int i = 0; i < symbols.size(); i++)
+            {
+                for(int j = i + 1; j < symbols.size(); j++)
+                {
+                    int a = symbols[i];
+                    int b = symbols[j];
+                    if(colour[a] != colour[b] || find(fixed.begin(), fixed.end(), a) != fixed.end() 
+                        || find(fixed.begin(), fixed.end(), b) != fixed.end())
+                    {
+                        continue;
+                    }
+                    bool verified = touching[a].size() == touching[b].size();
+                    for(int side = 0; side < 2 && verified; side++)
+                    {
+                        for(const pair<int, int>& occurrence : touching[side == 0 ? a : b])
+                        {
+                            const atom_set& atoms = sets[occurrence.first];
+                            if(atoms.find(swapped((*roles[occurrence.first])[occurrence.second], a, b)) == atoms.end())
+                            {
+                                verified = false;
+                                break;
+                            }
+                        }
+                    }
+                    vector<int> atom_map(index.size());
+                    for(int atom_id = 0; atom_id < index.size() && verified; atom_id++)
+                    {
+                        atom_map[atom_id] = index.lookup(swapped(index.get(atom_id), a, b));
+                        verified = atom_map[atom_id] >= 0;
+                    }
+                    //grounding may have pruned the image of an operator, e.g. through a static atom that only holds
+                    //for one of the two objects, the swap is no symmetry of the task then
+                    for(int op_ind = 0; op_ind < operators.size() && verified; op_ind++)
+                    {
+                        const ground_operator& op = operators[op_ind];
+                        vector<int> key{op.action};
+                        for(int arg : op.args)
+                        {
+                            key.push_back(arg == a ? b : (arg == b ? a : arg));
+                        }
+                        auto image = op_lookup.find(key);
+                        if(image == op_lookup.end())
+                        {
+                            verified = false;
+                            break;
+                        }
+                        const ground_operator& image_op = operators[image->second];
+                        verified = maps_onto(op.pre, image_op.pre, image_op.pre_mask, atom_map) 
+                            && maps_onto(op.add, image_op.add, image_op.add_mask, atom_map)
+                            && maps_onto(op.del, image_op.del, image_op.del_mask, atom_map);
+                    }
+                    if(verified)
+                    {
+                        swaps.push_back(make_pair(a, b));
+                        atom_maps.push_back(atom_map);
+                    }
+                }
+            }
+        }
+
+        //replaces the state in words by its representative. applied receives the generators used, in order. Returns
+        //how many were applied
+        int canonicalize(uint64_t* words, int num_words, vector<uint64_t>& scratch, vector<int>* applied) const
+        {
+            scratch.resize(num_words);
+            int count = 0;
+            bool improved = !atom_maps.empty();
+            while(improved)
+            {
+                improved = false;
+                for(int g = 0; g < atom_maps.size(); g++)
+                {
+                    fill(scratch.begin(), scratch.end(), 0);
+                    for(int i = 0; i < num_words; i++)
+                    {
+                        for(uint64_t word = words[i]; word != 0; word &= word - 1)
+                        {
+                            int image = atom_maps[g][(i << 6) + lowest_bit64(word)];
+                            scratch[image >> 6] |= 1ULL << (image & 63);
+                        }
+                    }
+                    if(lexicographical_compare(scratch.begin(), scratch.end(), words, words + num_words))
+                    {
+                        copy(scratch.begin(), scratch.end(), words);
+                        if(applied != nullptr)
+                        {
+                            applied->push_back(g);
+                        }
+                        count++;
+                        improved = true;
+                    }
+                }
+            }
+            return count;
+        }
+
+        //image of a symbol under generator g
+        int apply(int g, int symbol) const
+        {
+            if(symbol == swaps[g].first)
+            {
+                return swaps[g].second;
+            }
+            return symbol == swaps[g].second ? swaps[g].first : symbol;
+        }
+
+        int size() const
+        {
+            return swaps.size();
+        }
+};
+
+class GroundedCondition
+{
+private:
+    string predicate;
+    list<string> arg_values;
+    bool truth = true;
+    Atom atom; //interned form, used for hashing/comparison
+
+public:
+    GroundedCondition(string predicate, list<string> arg_values, bool truth = true)
+    {
+        this->predicate = predicate;
+        this->truth = truth;  // fixed
+        for (string l : arg_values)
+        {
+            this->arg_values.push_back(l);
+        }
+        this->atom = make_atom(predicate, arg_values);
+    }
+
+    GroundedCondition(const GroundedCondition& gc)
+    {
+        this->predicate = gc.predicate;
+        this->truth = gc.truth;  // fixed
+        for (string l : gc.arg_values)
+        {
+            this->arg_values.push_back(l);
+        }
+        this->atom = gc.atom;
+    }
+
+    string get_predicate() const
+    {
+        return this->predicate;
+    }
+    list<string> get_arg_values() const
+    {
+        return this->arg_values;
+    }
+
+    bool get_truth() const
+    {
+        return this->truth;
+    }
+
+    const Atom& get_atom() const
+    {
+        return this->atom;
+    }
+
+    friend ostream& operator<<(ostream& os, const GroundedCondition& pred)
+    {
+        os << pred.toString() << " ";
+        return os;
+    }
+
+    bool operator==(const GroundedCondition& rhs) const
+    {
+        if (this->atom != rhs.atom)
+            return false;
+
+        if (this->truth != rhs.get_truth()) // fixed
+            return false;
+
+        return true;
+    }
+
+    string toString() const
+    {
+        string temp = "";
+        temp += this->predicate;
+        temp += "(";
+        for (string l : this->arg_values)
+        {
+            temp += l + ",";
+        }
+        temp = temp.substr(0, temp.length() - 1);
+        temp += ")";
+        return temp;
+    }
+
+  
+};
+
+struct GroundedConditionComparator
+{
+    bool operator()(const GroundedCondition& lhs, const GroundedCondition& rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+struct GroundedConditionHasher
+{
+    size_t operator()(const GroundedCondition& gcond) const
+    {
+        return gcond.get_atom().hash_value;
+    }
+};
+
+class Condition
+{
+private:
+    string predicate;
+    list<string> args;
+    bool truth;
+    Atom atom; //interned form, args may still be action parameter names
+
+public:
+    Condition(string pred, list<string> args, bool truth)
+    {
+        this->predicate = pred;
+        this->truth = truth;
+        for (string ar : args)
+        {
+            this->args.push_back(ar);
+        }
+        this->atom = make_atom(pred, args);
+    }
+
+    string get_predicate() const
+    {
+        return this->predicate;
+    }
+
+    list<string> get_args() const
+    {
+        return this->args;
+    }
+
+    bool get_truth() const
+    {
+        return this->truth;
+    }
+
+    const Atom& get_atom() const
+    {
+        return this->atom;
+    }
+
+    friend ostream& operator<<(ostream& os, const Condition& cond)
+    {
+        os << cond.toString() << " ";
+        return os;
+    }
+
+    bool operator==(const Condition& rhs) const // fixed
+    {
+        if (this->atom != rhs.atom)
+            return false;
+
+        if (this->truth != rhs.get_truth())
+            return false;
+
+        return true;
+    }
+
+    string toString() const
+    {
+        string temp = "";
+        if (!this->truth)
+            temp += "!";
+        temp += this->predicate;
+        temp += "(";
+        for (string l : this->args)
+        {
+            temp += l + ",";
+        }
+        temp = temp.substr(0, temp.length() - 1);
+        temp += ")";
+        return temp;
+    }
+
+};
+
+struct ConditionComparator
+{
+    bool operator()(const Condition& lhs, const Condition& rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+struct ConditionHasher
+{
+    size_t operator()(const Condition& cond) const
+    {
+        return cond.get_atom().hash_value ^ cond.get_truth();
+    }
+};
+
+class Action
+{
+private:
+    string name;
+    list<string> args;
+    unordered_set<Condition, ConditionHasher, ConditionComparator> preconditions;
+    unordered_set<Condition, ConditionHasher, ConditionComparator> effects;
+    
+    //added
+    int num_args; 
+
+    //preconditions/effects with action parameters replaced by -(parameter index + 1), ready to be grounded by ground_atom
+    vector<Atom> lifted_preconditions;
+    vector<Atom> lifted_adds;
+    vector<Atom> lifted_deletes;
+    bool has_negated_precondition = false;
+    vector<bool> static_precondition; //per lifted precondition, set by mark_static_predicates
+
+    Atom lift_atom(const Condition& cond) const
+    {
+        Atom lifted = cond.get_atom();
+        for(int i = 0; i < lifted.arity; i++)
+        {
+            int param_ind = 0;
+            for(const string& param : this->args)
+            {
+                if(symbol_table.lookup(param) == lifted.args[i])
+                {
+                    lifted.args[i] = -(param_ind + 1);
+                    break;
+                }
+                param_ind++;
+            }
+        }
+        return lifted;
+    }
+
+public:
+    Action(string name, list<string> args,
+        unordered_set<Condition, ConditionHasher, ConditionComparator>& preconditions,
+        unordered_set<Condition, ConditionHasher, ConditionComparator>& effects)
+    {
+        this->name = name;
+        for (string l : args)
+        {
+            this->args.push_back(l);
+            symbol_table.intern(l);
+        }
+        for (Condition pc : preconditions)
+        {
+            this->preconditions.insert(pc);
+            if(pc.get_truth())
+            {
+                this->lifted_preconditions.push_back(lift_atom(pc));
+            }
+            else
+            {
+                this->has_negated_precondition = true;
+            }
+        }
+        for (Condition pc : effects)
+        {
+            this->effects.insert(pc);
+            if(pc.get_truth())
+            {
+                this->lifted_adds.push_back(lift_atom(pc));
+            }
+            else
+            {
+                this->lifted_deletes.push_back(lift_atom(pc));
+            }
+        }
+
+        this->num_args = args.size();
+        
+    }
+
+    string get_name() const
+    {
+        return this->name;
+    }
+    list<string> get_args() const
+    {
+        return this->args;
+    }
+    unordered_set<Condition, ConditionHasher, ConditionComparator> get_preconditions() const
+    {
+        return this->preconditions;
+    }
+    unordered_set<Condition, ConditionHasher, ConditionComparator> get_effects() const
+    {
+        return this->effects;
+    }
+
+    bool operator==(const Action& rhs) const
+    {
+        if (this->get_name() != rhs.get_name() || this->get_args().size() != rhs.get_args().size())
+            return false;
+
+        return true;
+    }
+
+    friend ostream& operator<<(ostream& os, const Action& ac)
+    {
+        os << ac.toString() << endl;
+        os << "Precondition: ";
+        for (Condition precond : ac.get_preconditions())
+            os << precond;
+        os << endl;
+        os << "Effect: ";
+        for (Condition effect : ac.get_effects())
+            os << effect;
+        os << endl;
+        return os;
+    }
+
+    string toString() const
+    {
+        string temp = "";
+        temp += this->get_name();
+        temp += "(";
+        for (string l : this->get_args())
+        {
+            temp += l + ",";
+        }
+        temp = temp.substr(0, temp.length() - 1);
+        temp += ")";
+        return temp;
+    }
+    
+    int get_num_args() const
+    {
+        return this->num_args;
+    }
+
+    const vector<Atom>& get_lifted_preconditions() const
+    {
+        return this->lifted_preconditions;
+    }
+
+    const vector<Atom>& get_lifted_adds() const
+    {
+        return this->lifted_adds;
+    }
+
+    const vector<Atom>& get_lifted_deletes() const
+    {
+        return this->lifted_deletes;
+    }
+
+    //substitutes the input args into a compiled precondition/effect
+    Atom ground_atom(const Atom& lifted, const vector<int>& input_args) const
+    {
+        Atom grounded = lifted;
+        for(int i = 0; i < grounded.arity; i++)
+        {
+            if(grounded.args[i] < 0)
+            {
+                grounded.args[i] = input_args[-grounded.args[i] - 1];
+            }
+        }
+        finalize_atom(grounded);
+        return grounded;
+    }
+
+    //flags the preconditions whose predicate never changes, they are evaluated once during grounding instead of during search
+    void mark_static_predicates(const unordered_set<int>& static_predicates)
+    {
+        static_precondition.assign(lifted_preconditions.size(), false);
+        for(int i = 0; i < lifted_preconditions.size(); i++)
+        {
+            static_precondition[i] = static_predicates.find(lifted_preconditions[i].predicate) != static_predicates.end();
+        }
+    }
+
+    //relaxed applicability used while building the atom index: static preconditions must hold in the static atoms,
+    //every other precondition must already be indexed
+    bool preconditions_reachable(const atom_index& index, const atom_set& static_atoms, const vector<int>& input_args) const
+    {
+        if(this->has_negated_precondition) //states only hold true atoms, so a negated precondition never matches
+        {
+            return false;
+        }
+        for(int i = 0; i < lifted_preconditions.size(); i++)
+        {
+            Atom grounded = ground_atom(lifted_preconditions[i], input_args);
+            if(static_precondition[i] ? static_atoms.find(grounded) == static_atoms.end() : index.lookup(grounded) < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //indexes the add effects, returns true if any of them was new
+    bool index_adds(atom_index& index, const vector<int>& input_args) const
+    {
+        int before = index.size();
+        for(const Atom& effect : lifted_adds)
+        {
+            index.add(ground_atom(effect, input_args));
+        }
+        return index.size() != before;
+    }
+
+    //binds the input args, all non-static preconditions/adds must already be in the index.
+    //static preconditions are already known to hold and deletes of atoms that are never true cannot change a state, both are dropped
+    ground_operator ground(int action_id, const atom_index& index, const vector<int>& input_args) const
+    {
+        ground_operator op;
+        op.action = action_id;
+        op.args = input_args;
+        op.pre_mask = state_bits(index.size());
+        op.add_mask = state_bits(index.size());
+        op.del_mask = state_bits(index.size());
+        for(int i = 0; i < lifted_preconditions.size(); i++)
+        {
+            if(static_precondition[i])
+            {
+                continue;
+            }
+            int atom_id = index.lookup(ground_atom(lifted_preconditions[i], input_args));
+            if(!op.pre_mask.test(atom_id))
+            {
+                op.pre.push_back(atom_id);
+                op.pre_mask.set(atom_id);
+            }
+        }
+        for(const Atom& effect : lifted_adds)
+        {
+            int atom_id = index.lookup(ground_atom(effect, input_args));
+            if(!op.add_mask.test(atom_id))
+            {
+                op.add.push_back(atom_id);
+                op.add_mask.set(atom_id);
+            }
+        }
+        for(const Atom& effect : lifted_deletes)
+        {
+            int atom_id = index.lookup(ground_atom(effect, input_args));
+            if(atom_id >= 0 && !op.del_mask.test(atom_id))
+            {
+                op.del.push_back(atom_id);
+                op.del_mask.set(atom_id);
+            }
+        }
+        return op;
+    }
+
+};
+
+struct ActionComparator
+{
+    bool operator()(const Action& lhs, const Action& rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+struct ActionHasher
+{
+    size_t operator()(const Action& ac) const
+    {
+        return hash<string>{}(ac.get_name());
+    }
+};
+
+class Env
+{
+private:
+    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> initial_conditions;
+    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> goal_conditions;
+    unordered_set<Action, ActionHasher, ActionComparator> actions;
+    unordered_set<string> symbols;
+
+public:
+    void remove_initial_condition(GroundedCondition gc)
+    {
+        this->initial_conditions.erase(gc);
+    }
+    void add_initial_condition(GroundedCondition gc)
+    {
+        this->initial_conditions.insert(gc);
+    }
+    void add_goal_condition(GroundedCondition gc)
+    {
+        this->goal_conditions.insert(gc);
+    }
+    void remove_goal_condition(GroundedCondition gc)
+    {
+        this->goal_conditions.erase(gc);
+    }
+    void add_symbol(string symbol)
+    {
+        symbols.insert(symbol);
+        // sym_map[symbol] = symbol;
+    }
+    void add_symbols(list<string> symbols)
+    {
+        for (string l : symbols)
+            this->symbols.insert(l);
+    }
+    void add_action(Action action)
+    {
+        this->actions.insert(action);
+    }
+
+    Action get_action(string name)
+    {
+        for (Action a : this->actions)
+        {
+            if (a.get_name() == name)
+                return a;
+        }
+        throw runtime_error("Action " + name + " not found!");
+    }
+
+    unordered_set<Action, ActionHasher, ActionComparator> get_actions() const 
+    {
+        return this->actions;
+    }
+
+    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> get_initial_conditions() const
+    {
+        return this->initial_conditions;
+    }
+    
+    unordered_set<GroundedCondition, GroundedConditionHasher, GroundedConditionComparator> get_goal_conditions() const
+    {
+        return this->goal_conditions;
+    }
+
+    unordered_set<Condition, ConditionHasher, ConditionComparator> get_initial_ungrounded()
+    {
+        unordered_set<Condition, ConditionHasher, ConditionComparator> ret_val; 
+
+        for(auto ground_it:initial_conditions)
+        {
+            Condition temp_cond = Condition(ground_it.get_predicate(), ground_it.get_arg_values(), ground_it.get_truth());
+            ret_val.insert(temp_cond);
+        }
+
+        return ret_val;
+    }
+
+    unordered_set<Condition, ConditionHasher, ConditionComparator> get_goal_ungrounded()
+    {
+        unordered_set<Condition, ConditionHasher, ConditionComparator> ret_val; 
+
+        for(auto ground_it:goal_conditions)
+        {
+            Condition temp_cond = Condition(ground_it.get_predicate(), ground_it.get_arg_values(), ground_it.get_truth());
+            ret_val.insert(temp_cond);
+        }
+        return ret_val;
+    }
+
+    unordered_set<string> get_symbols() const
+    {
+        return this->symbols;
+    }
+
+    friend ostream& operator<<(ostream& os, const Env& w)
+    {
+        os << "***** Environment *****" << endl << endl;
+        os << "Symbols: ";
+        for (string s : w.get_symbols())
+            os << s + ",";
+        os << endl;
+        os << "Initial conditions: ";
+        for (GroundedCondition s : w.initial_conditions)
+            os << s;
+        os << endl;
+        os << "Goal conditions: ";
+        for (GroundedCondition g : w.goal_conditions)
+            os << g;
+        os << endl;
+        os << "Actions:" << endl;
+        for (Action g : w.actions)
+            os << g << endl;
+        cout << "***** Environment Created! *****" << endl;
+        return os;
+    }
+};
+
+class GroundedAction
+{
+private:
+    string name;
+    list<string> arg_values;
+
+public:
+    GroundedAction(string name, list<string> arg_values)
+    {
+        this->name = name;
+        for (string ar : arg_values)
+        {
+            this->arg_values.push_back(ar);
+        }
+    }
+
+    string get_name() const
+    {
+        return this->name;
+    }
+
+    list<string> get_arg_values() const
+    {
+        return this->arg_values;
+    }
+
+    bool operator==(const GroundedAction& rhs) const
+    {
+        if (this->name != rhs.name || this->arg_values.size() != rhs.arg_values.size())
+            return false;
 
         auto lhs_it = this->arg_values.begin();
         auto rhs_it = rhs.arg_values.begin();
 
-        while (lhs_it != this->arg_values.end() && rhs_it != rhs.arg_values.end())
+        while (lhs_it != this->arg_values.end() && rhs_it != rhs.arg_values.end())
+        {
+            if (*lhs_it != *rhs_it)
+                return false;
+            ++lhs_it;
+            ++rhs_it;
+        }
+        return true;
+    }
+
+    friend ostream& operator<<(ostream& os, const GroundedAction& gac)
+    {
+        os << gac.toString() << " ";
+        return os;
+    }
+
+    string toString() const
+    {
+        string temp = "";
+        temp += this->name;
+        temp += "(";
+        for (string l : this->arg_values)
+        {
+            temp += l + ",";
+        }
+        temp = temp.substr(0, temp.length() - 1);
+        temp += ")";
+        return temp;
+    }
+};
+
+list<string> parse_symbols(string symbols_str)
+{
+    list<string> symbols;
+    size_t pos = 0;
+    string delimiter = ",";
+    while ((pos = symbols_str.find(delimiter)) != string::npos)
+    {
+        string symbol = symbols_str.substr(0, pos);
+        symbols_str.erase(0, pos + delimiter.length());
+        symbols.push_back(symbol);
+    }
+    symbols.push_back(symbols_str);
+    return symbols;
+}
+
+Env* create_env(char* filename)
+{
+    ifstream input_file(filename);
+    Env* env = new Env();
+    regex symbolStateRegex("symbols:", regex::icase);
+    regex symbolRegex("([a-zA-Z0-9_, ]+) *");
+    regex initialConditionRegex("initialconditions:(.*)", regex::icase);
+    regex conditionRegex("(!?[A-Z][a-zA-Z_]*) *\\( *([a-zA-Z0-9_, ]+) *\\)");
+    regex goalConditionRegex("goalconditions:(.*)", regex::icase);
+    regex actionRegex("actions:", regex::icase);
+    regex precondRegex("preconditions:(.*)", regex::icase);
+    regex effectRegex("effects:(.*)", regex::icase);
+    int parser = SYMBOLS;
+
+    unordered_set<Condition, ConditionHasher, ConditionComparator> preconditions;
+    unordered_set<Condition, ConditionHasher, ConditionComparator> effects;
+    string action_name;
+    string action_args;
+
+    string line;
+    if (input_file.is_open())
+    {
+        while (getline(input_file, line))
+        {
+            string::iterator end_pos = remove(line.begin(), line.end(), ' ');
+            line.erase(end_pos, line.end());
+
+            if (line == "")
+                continue;
+
+            if (parser == SYMBOLS)
+            {
+                smatch results;
+                if (regex_search(line, results, symbolStateRegex))
+                {
+                    line = line.substr(8);
+                    sregex_token_iterator iter(line.begin(), line.end(), symbolRegex, 0);
+                    sregex_token_iterator end;
+
+                    list<string> parsed_symbols = parse_symbols(iter->str());
+                    for (string symbol : parsed_symbols)
+                    {
+                        symbol_table.intern(symbol); //environment symbols get the lowest ids
+                    }
+                    env->add_symbols(parsed_symbols);  // fixed
+
+                    parser = INITIAL;
+                }
+                else
+                {
+                    cout << "Symbols are not specified correctly." << endl;
+                    throw;
+                }
+            }
+            else if (parser == INITIAL)
+            {
+                const char* line_c = line.c_str();
+                if (regex_match(line_c, initialConditionRegex))
+                {
+                    const std::vector<int> submatches = { 1, 2 };
+                    sregex_token_iterator iter(
+                        line.begin(), line.end(), conditionRegex, submatches);
+                    sregex_token_iterator end;
+
+                    while (iter != end)
+                    {
+                        // name
+                        string predicate = iter->str();
+                        iter++;
+                        // args
+                        string args = iter->str();
+                        iter++;
+
+                        if (predicate[0] == '!')
+                        {
+                            env->remove_initial_condition(
+                                GroundedCondition(predicate.substr(1), parse_symbols(args)));
+                        }
+                        else
+                        {
+                            env->add_initial_condition(
+                                GroundedCondition(predicate, parse_symbols(args)));
+                        }
+                    }
+
+                    parser = GOAL;
+                }
+                else
+                {
+                    cout << "Initial conditions not specified correctly." << endl;
+                    throw;
+                }
+            }
+            else if (parser == GOAL)
+            {
+                const char* line_c = line.c_str();
+                if (regex_match(line_c, goalConditionRegex))
+                {
+                    const std::vector<int> submatches = { 1, 2 };
+                    sregex_token_iterator iter(
+                        line.begin(), line.end(), conditionRegex, submatches);
+                    sregex_token_iterator end;
+
+                    while (iter != end)
+                    {
+                        // name
+                        string predicate = iter->str();
+                        iter++;
+                        // args
+                        string args = iter->str();
+                        iter++;
+
+                        if (predicate[0] == '!')
+                        {
+                            env->remove_goal_condition(
+                                GroundedCondition(predicate.substr(1), parse_symbols(args)));
+                        }
+                        else
+                        {
+                            env->add_goal_condition(
+                                GroundedCondition(predicate, parse_symbols(args)));
+                        }
+                    }
+
+                    parser = ACTIONS;
+                }
+                else
+                {
+                    cout << "Goal conditions not specified correctly." << endl;
+                    throw;
+                }
+            }
+            else if (parser == ACTIONS)
+            {
+                const char* line_c = line.c_str();
+                if (regex_match(line_c, actionRegex))
+                {
+                    parser = ACTION_DEFINITION;
+                }
+                else
+                {
+                    cout << "Actions not specified correctly." << endl;
+                    throw;
+                }
+            }
+            else if (parser == ACTION_DEFINITION)
+            {
+                const char* line_c = line.c_str();
+                if (regex_match(line_c, conditionRegex))
+                {
+                    const std::vector<int> submatches = { 1, 2 };
+                    sregex_token_iterator iter(
+                        line.begin(), line.end(), conditionRegex, submatches);
+                    sregex_token_iterator end;
+                    // name
+                    action_name = iter->str();
+                    iter++;
+                    // args
+                    action_args = iter->str();
+                    iter++;
+
+                    parser = ACTION_PRECONDITION;
+                }
+                else
+                {
+                    cout << "Action not specified correctly." << endl;
+                    throw;
+                }
+            }
+            else if (parser == ACTION_PRECONDITION)
+            {
+                const char* line_c = line.c_str();
+                if (regex_match(line_c, precondRegex))
+                {
+                    const std::vector<int> submatches = { 1, 2 };
+                    sregex_token_iterator iter(
+                        line.begin(), line.end(), conditionRegex, submatches);
+                    sregex_token_iterator end;
+
+                    while (iter != end)
+                    {
+                        // name
+                        string predicate = iter->str();
+                        iter++;
+                        // args
+                        string args = iter->str();
+                        iter++;
+
+                        bool truth;
+
+                        if (predicate[0] == '!')
+                        {
+                            predicate = predicate.substr(1);
+                            truth = false;
+                        }
+                        else
+                        {
+                            truth = true;
+                        }
+
+                        Condition precond(predicate, parse_symbols(args), truth);
+                        preconditions.insert(precond);
+                    }
+
+                    parser = ACTION_EFFECT;
+                }
+                else
+                {
+                    cout << "Precondition not specified correctly." << endl;
+                    throw;
+                }
+            }
+            else if (parser == ACTION_EFFECT)
+            {
+                const char* line_c = line.c_str();
+                if (regex_match(line_c, effectRegex))
+                {
+                    const std::vector<int> submatches = { 1, 2 };
+                    sregex_token_iterator iter(
+                        line.begin(), line.end(), conditionRegex, submatches);
+                    sregex_token_iterator end;
+
+                    while (iter != end)
+                    {
+                        // name
+                        string predicate = iter->str();
+                        iter++;
+                        // args
+                        string args = iter->str();
+                        iter++;
+
+                        bool truth;
+
+                        if (predicate[0] == '!')
+                        {
+                            predicate = predicate.substr(1);
+                            truth = false;
+                        }
+                        else
+                        {
+                            truth = true;
+                        }
+
+                        Condition effect(predicate, parse_symbols(args), truth);
+                        effects.insert(effect);
+                    }
+
+                    env->add_action(
+                        Action(action_name, parse_symbols(action_args), preconditions, effects));
+
+                    preconditions.clear();
+                    effects.clear();
+                    parser = ACTION_DEFINITION;
+                }
+                else
+                {
+                    cout << "Effects not specified correctly." << endl;
+                    throw;
+                }
+            }
+        }
+        input_file.close();
+    }
+
+    else
+        cout << "Unable to open file";
+
+    return env;
+}
+
+
+//mutex groups of the grounded task: sets of atoms of which at most one is true in any reachable state. Candidates come
+//from the action schemas: an action that deletes one of its preconditions and adds another atom suggests that atoms of
+//the two predicates agreeing on the arguments (parameters or constants) both atoms share exclude each other (On(b,*)
+//for Move(b,x,y), At(R,*) for MoveToLoc, HighCharge(Q) and LowCharge(Q) for a pour). Every ground instance of a
+//candidate is verified on the ground operators before it is kept: an operator adding an atom of the group has to delete
+//one of its own preconditions from it
+class mutex_groups
+{
+    private:
+        vector<vector<int>> groups; //verified, they may overlap
+        vector<uint8_t> exactly_one; //the group also always holds one true atom
+        int num_atoms = 0;
+
+        static int position_of(const Atom& atom, int arg)
+        {
+            for(int k = 0; k < atom.arity; k++)
+            {
+                if(atom.args[k] == arg)
+                {
+                    return k;
+                }
+            }
+            return -1;
+        }
+
+        //at most one atom of the group is true initially and no operator can make a second one true. exact is set if
+        //exactly one is true initially and every operator deleting one adds another
+        bool verify(const vector<int>& group, const vector<ground_operator>& operators, const state_view& init, 
+            vector<uint8_t>& in_group, bool& exact)
+        {
+            int initially = 0;
+            for(int atom_id : group)
+            {
+                in_group[atom_id] = 1;
+                initially += init.test(atom_id);
+            }
+            bool valid = initially <= 1;
+            exact = initially == 1;
+            for(int i = 0; i < operators.size() && valid; i++)
+            {
+                const ground_operator& op = operators[i];
+                int added = 0;
+                bool adds_new = false;
+                for(int atom_id : op.add)
+                {
+                    if(in_group[atom_id])
+                    {
+                        added++;
+                        adds_new |= !op.pre_mask.test(atom_id);
+                    }
+                }
+                bool deletes = false;
+                bool deletes_precondition = false;
+                for(int atom_id : op.del)
+                {
+                    if(in_group[atom_id] && !op.add_mask.test(atom_id)) //adds win over deletes
+                    {
+                        deletes = true;
+                        deletes_precondition |= op.pre_mask.test(atom_id);
+                    }
+                }
+                valid = added <= 1 && (!adds_new || deletes_precondition);
+                exact &= !deletes || added == 1;
+            }
+            for(int atom_id : group)
+            {
+                in_group[atom_id] = 0;
+            }
+            return valid;
+        }
+
+    public:
+        void synthesize(const vector<Action>& actions, const vector<ground_operator>& operators, const atom_index& index, 
+            const state_view& init)
+        {
+            num_atoms = index.size();
+            groups.clear();
+            exactly_one.clear();
+
+            //candidate: per predicate {predicate, positions of the shared parameters...}, sorted
+            set<vector<vector<int>>> candidates;
+            for(const Action& act : actions)
+            {
+                for(const Atom& deleted : act.get_lifted_deletes())
+                {
+                    if(find(act.get_lifted_preconditions().begin(), act.get_lifted_preconditions().end(), deleted) 
+                        == act.get_lifted_preconditions().end())
+                    {
+                        continue;
+                    }
+                    for(const Atom& added : act.get_lifted_adds())
+                    {
+                        if(added == deleted)
+                        {
+                            continue;
+                        }
+                        vector<int> added_member{added.predicate};
+                        vector<int> deleted_member{deleted.predicate};
+                        for(int k = 0; k < deleted.arity; k++)
+                        {
+                            int arg = deleted.args[k];
+                            if(position_of(deleted, arg) == k && position_of(added, arg) >= 0) //shared argument
+                            {
+                                deleted_member.push_back(k);
+                                added_member.push_back(position_of(added, arg));
+                            }
+                        }
+                        vector<vector<int>> candidate{added_member, deleted_member};
+                        sort(candidate.begin(), candidate.end());
+                        candidate.erase(unique(candidate.begin(), candidate.end()), candidate.end());
+                        candidates.insert(candidate);
+                    }
+                }
+            }
+
+            set<vector<int>> seen;
+            vector<uint8_t> in_group(num_atoms, 0);
+            for(const vector<vector<int>>& candidate : candidates)
+            {
+                map<vector<int>, vector<int>> instances; //shared argument values -> atoms
+                for(int atom_id = 0; atom_id < num_atoms; atom_id++)
+                {
+                    const Atom& atom = index.get(atom_id);
+                    for(const vector<int>& member : candidate)
+                    {
+                        if(member[0] != atom.predicate)
+                        {
+                            continue;
+                        }
+                        vector<int> key;
+                        for(int i = 1; i < member.size(); i++)
+                        {
+                            key.push_back(atom.args[member[i]]);
+                        }
+                        vector<int>& group = instances[key];
+                        if(group.empty() || group.back() != atom_id)
+                        {
+                            group.push_back(atom_id);
+                        }
+                    }
+                }
+                for(const pair<const vector<int>, vector<int>>& instance : instances)
+                {
+                    bool exact;
+                    if(instance.second.size() > 1 && seen.insert(instance.second).second 
+                        && verify(instance.second, operators, init, in_group, exact))
+                    {
+                        groups.push_back(instance.second);
+                        exactly_one.push_back(exact);
+                    }
+                }
+            }
+        }
+
+        //disjoint groups for the finite-domain encoding, greedily taking the group with the most atoms not yet covered.
+        //A group that lost atoms to an earlier one is no longer exactly-one
+        void partition(vector<vector<int>>& cover, vector<uint8_t>& cover_exactly_one) const
+        {
+            cover.clear();
+            cover_exactly_one.clear();
+            vector<uint8_t> covered(num_atoms, 0);
+            while(true)
+            {
+                int best = -1;
+                int best_size = 1;
+                for(int g = 0; g < groups.size(); g++)
+                {
+                    int size = 0;
+                    for(int atom_id : groups[g])
+                    {
+                        size += !covered[atom_id];
+                    }
+                    if(size > best_size)
+                    {
+                        best = g;
+                        best_size = size;
+                    }
+                }
+                if(best < 0)
+                {
+                    return;
+                }
+                cover.push_back(vector<int>());
+                for(int atom_id : groups[best])
+                {
+                    if(!covered[atom_id])
+                    {
+                        covered[atom_id] = 1;
+                        cover.back().push_back(atom_id);
+                    }
+                }
+                cover_exactly_one.push_back(exactly_one[best] && best_size == groups[best].size());
+            }
+        }
+
+        int size() const
+        {
+            return groups.size();
+        }
+};
+
+//open list for small integer priorities: one bucket per f, split into sub-buckets per h so that the larger h wins
+//ties on f. Cursors only move forward between pushes below them, so push and pop are amortized O(1). Entries of
+//one (f, h) bucket leave in insertion order (FIFO) or reverse (LIFO). Entry needs int f and h >= 0
+template<typename Entry>
+class bucket_queue
+{
+    private:
+        struct bucket
+        {
+            vector<Entry> entries;
+            size_t head = 0; //FIFO read position, entries before it are popped
+            
+            bool empty() const
+            {
+                return head == entries.size();
+            }
+        };
+        struct f_layer
+        {
+            vector<bucket> by_h;
+            int max_h = -1; //no non-empty sub-bucket above it
+            size_t count = 0;
+        };
+
+        vector<f_layer> layers;
+        int min_f = 0; //no non-empty layer below it
+        size_t count = 0;
+        bool lifo = false;
+
+        bucket& best()
         {
-            if (*lhs_it != *rhs_it)
+            while(layers[min_f].count == 0)
+            {
+                min_f++;
+            }
+            f_layer& layer = layers[min_f];
+            while(layer.by_h[layer.max_h].empty())
+            {
+                layer.max_h--;
+            }
+            return layer.by_h[layer.max_h];
+        }
+
+    public:
+        void set_lifo(bool lifo_in)
+        {
+            lifo = lifo_in;
+        }
+
+        void push(const Entry& entry)
+        {
+            if(entry.f >= layers.size())
+            {
+                layers.resize(entry.f + 1);
+            }
+            f_layer& layer = layers[entry.f];
+            if(entry.h >= layer.by_h.size())
+            {
+                layer.by_h.resize(entry.h + 1);
+            }
+            layer.by_h[entry.h].entries.push_back(entry);
+            layer.max_h = max(layer.max_h, entry.h);
+            layer.count++;
+            min_f = (count == 0) ? entry.f : min(min_f, entry.f);
+            count++;
+        }
+
+        const Entry& top()
+        {
+            bucket& b = best();
+            return lifo ? b.entries.back() : b.entries[b.head];
+        }
+
+        void pop()
+        {
+            bucket& b = best();
+            if(lifo)
+            {
+                b.entries.pop_back();
+            }
+            else
+            {
+                b.head++;
+            }
+            if(b.empty())
+            {
+                b.entries.clear();
+                b.head = 0;
+            }
+            layers[min_f].count--;
+            count--;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        void clear()
+        {
+            layers = vector<f_layer>();
+            min_f = 0;
+            count = 0;
+        }
+};
+
+//fixed set of worker threads running one job at a time, the calling thread takes part as worker 0
+class thread_pool
+{
+    private:
+        vector<thread> threads;
+        mutex lock;
+        condition_variable start_signal;
+        condition_variable done_signal;
+        function<void(int)> job; //called once per worker with its index
+        int generation = 0; //bumped for every job
+        int running = 0; //helper threads still inside the current job
+        bool stopping = false;
+
+        void worker_loop(int worker)
+        {
+            int seen = 0;
+            unique_lock<mutex> guard(lock);
+            while(true)
+            {
+                start_signal.wait(guard, [&]() { return stopping || generation != seen; });
+                if(stopping)
+                {
+                    return;
+                }
+                seen = generation;
+                guard.unlock();
+                job(worker);
+                guard.lock();
+                if(--running == 0)
+                {
+                    done_signal.notify_one();
+                }
+            }
+        }
+
+    public:
+        thread_pool()
+        {
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            start_signal.notify_all();
+            for(thread& t : threads)
+            {
+                t.join();
+            }
+        }
+
+        void init(int num_workers)
+        {
+            for(int worker = 1; worker < num_workers; worker++)
+            {
+                threads.emplace_back(&thread_pool::worker_loop, this, worker);
+            }
+        }
+
+        int size() const
+        {
+            return threads.size() + 1;
+        }
+
+        //runs f(worker) on every worker and returns once all of them are done
+        void run(const function<void(int)>& f)
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                job = f;
+                running = threads.size();
+                generation++;
+            }
+            start_signal.notify_all();
+            f(0);
+            unique_lock<mutex> guard(lock);
+            done_signal.wait(guard, [&]() { return running == 0; });
+        }
+};
+
+//lock-free multi-producer single-consumer queue (Vyukov): producers swap themselves in as the head, the single
+//consumer follows the next links from a stub node it owns
+template<typename T>
+class mpsc_queue
+{
+    private:
+        struct node
+        {
+            atomic<node*> next{nullptr};
+            T value;
+        };
+        atomic<node*> head;
+        node* tail; //consumer side stub, its value has been taken already
+
+    public:
+        mpsc_queue()
+        {
+            tail = new node();
+            head.store(tail);
+        }
+
+        mpsc_queue(const mpsc_queue&) = delete;
+        mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+        ~mpsc_queue()
+        {
+            T value;
+            while(pop(value))
+            {
+            }
+            delete tail;
+        }
+
+        //any thread
+        void push(T value)
+        {
+            node* added = new node();
+            added->value = std::move(value);
+            node* previous = head.exchange(added, memory_order_acq_rel);
+            previous->next.store(added, memory_order_release);
+        }
+
+        //consumer thread only, false if nothing has been published yet
+        bool pop(T& out)
+        {
+            node* next = tail->next.load(memory_order_acquire);
+            if(next == nullptr)
+            {
                 return false;
-            ++lhs_it;
-            ++rhs_it;
+            }
+            out = std::move(next->value);
+            delete tail;
+            tail = next;
+            return true;
+        }
+};
+
+enum heuristic_type 
+{ 
+    GOAL_COUNT, //number of unsatisfied goal atoms
+    H_ADD, //additive delete-relaxation heuristic
+    H_MAX, //max delete-relaxation heuristic, admissible
+    FF, //relaxed plan length
+    LM_COUNT, //landmark count over the accepted landmarks of the path
+    PDB //pattern database collection, admissible
+};
+
+enum search_type
+{
+    BEST_FIRST, //single open list (weighted) A*, see generate_tree
+    HDA_STAR, //hash-distributed A* on threads workers, each owning the states whose hash maps to it
+    GBFS, //lazy greedy best-first search ordered by h alone
+    EHC, //enforced hill-climbing, falls back to GBFS when it gets stuck
+    REGRESSION, //backward search over partial states from the goal
+    BIDIRECTIONAL //forward and regression search alternating until a forward state satisfies a partial state
+};
+
+struct planner_options
+{
+    search_type search = BEST_FIRST;
+    heuristic_type heuristic = GOAL_COUNT;
+    bool preferred_operators = false; //second open list holding only successors reached by FF helpful actions
+    int preference_boost = 1000; //expansions granted to the preferred list whenever a new best h is found
+    int pdb_pattern_size = 12; //atoms per pattern (at most 20), each pattern database has 2^size entries
+    int threads = 1; //workers evaluating the successors of an expansion, or HDA* partitions
+    int parallel_min_successors = 16; //smaller expansions are evaluated on the calling thread, a dispatch costs more than that
+    bool lifo_ties = false; //order of open entries with equal f and h, insertion order by default
+    double weight = 3.0; //f = g + weight*h
+    bool partial_order_reduction = false; //expand only the applicable operators of a strong stubborn set
+    bool symmetry_reduction = false; //duplicate detection over one representative per class of symmetric states
+    bool finite_domain_encoding = false; //store search states packed as finite-domain variables over the mutex groups
+    bool anytime = false; //ARA*: keep lowering the weight and publishing better plans until the deadline
+    double weight_decrement = 0.5; //weight step between anytime iterations, the last iteration runs at weight 1
+    double deadline_seconds = 1.0; //anytime search stops improving after this, a first plan is always searched to the end
+    function<void(const list<GroundedAction>&, int)> plan_callback; //called with every published plan and its cost
+    atomic<bool>* cancel = nullptr; //set by another thread to stop the search, e.g. a portfolio that has a plan
+    bool verbose = true; //progress output, portfolio members run silently so that their lines do not interleave
+};
+
+//everything grounding produces. It is read-only once the search starts, so planners of a portfolio share one copy
+struct grounded_task
+{
+    atom_index index; //reachable ground atoms, one bit each in every state
+    zobrist_table zobrist;
+    state_bits start_condition;
+    state_bits goal_condition; //mask of goal atoms
+    vector<int> symbols; //interned ids, vector instead of unordered set for ease of indexing in generating combinations
+    vector<Action> actions;
+    vector<ground_operator> operators; //every relaxed-reachable action instance, grounded once before search
+    unordered_set<int> static_predicates; //predicate ids never changed by an action effect
+    successor_generator successors;
+    vector<Atom> init_atoms; //initial atoms, static ones included, kept for symmetry detection
+    vector<Atom> goal_atoms;
+    //the analyses below only run once a configuration asks for them. Planners sharing the task prepare their search one
+    //after the other before any of them starts, so the first one that needs an analysis runs it for all
+    object_symmetries symmetries;
+    bool symmetries_detected = false;
+    mutex_groups mutexes;
+    state_packer packer; //finite-domain encoding over a disjoint cover of the mutex groups
+    bool mutexes_synthesized = false;
+};
+
+class symbo_planner
+{
+    private:
+        //one open list record: a path to state id, the per-state data lives in search_info
+        struct open_entry
+        {
+            int f;
+            int h; //weighted heuristic, used for tie-breaking
+            int g;
+            state_id id;
+            state_id parent;
+            int op; //operator that generated this path
+        };
+
+        bucket_queue<open_entry> open_list; //lower f first, larger h on ties
+        bucket_queue<open_entry> preferred_open; //successors via helpful actions only
+        int open_priority = 0; //the list with the lower priority is served next, ties go to the preferred list
+        int preferred_priority = 0;
+        int best_h = DEAD_END; //lowest h generated so far, improving it boosts the preferred list
+        int preferred_expansions = 0;
+        int peak_open = 0; //largest number of open entries at any time
+        int parallel_expansions = 0; //expansions whose successors were evaluated on the thread pool
+        vector<int> helpful; //scratch for the helpful actions of the expanded state
+        vector<uint8_t> is_helpful; //indexed by operator
+        double weight; //current heuristic weight, lowered between anytime iterations
+        vector<open_entry> incons; //anytime: better paths found to states already expanded in this iteration
+        state_registry registry; //every generated state, stored once
+        search_info info; //g, h, parent and creating operator per state id
+        int expanded = 0;
+        shared_ptr<grounded_task> task;
+        atom_index& index;
+        zobrist_table& zobrist;
+        state_bits& start_condition;
+        state_bits& goal_condition;
+        vector<int>& symbols;
+        vector<Action>& actions;
+        vector<ground_operator>& operators;
+        unordered_set<int>& static_predicates;
+        successor_generator& successors;
+        object_symmetries& symmetries;
+        mutex_groups& mutexes;
+        state_packer& packer;
+        list<GroundedAction> final_plan;
+        chrono::time_point<chrono::system_clock> startTime;
+        planner_options options;
+        relaxed_graph relaxation; //h_add / h_max / FF engine
+        thread_pool workers;
+        vector<relaxed_graph> worker_relaxations; //per-worker copies, the engine keeps scratch state
+
+        //per applicable operator result of the parallel phase of an expansion
+        struct successor_eval
+        {
+            uint64_t hash;
+            bool duplicate;
+            int h; //-1 if it was not evaluated
+        };
+        vector<successor_eval> evaluated;
+        landmark_graph landmarks;
+        pdb_collection pattern_databases;
+        stubborn_sets pruning;
+        bool use_symmetries = false; //search states are symmetry representatives, plans are unfolded when extracted
+        vector<uint64_t> canonical; //scratch for the representative of the state being generated
+        vector<uint64_t> expanded_words; //holds the expanded state while its successors are looked up
+        vector<uint64_t> lookup_words; //decodes states that are only tested or evaluated, never held across another lookup
+        vector<uint64_t> partial_words; //regression states, the backward registry is never packed but takes a buffer all the same
+        vector<uint64_t> symmetry_scratch;
+        int symmetric_successors = 0; //successors replaced by a different representative
+
+        //regression search over partial states: a state holds the atoms that still have to be achieved. Parents point
+        //towards the goal, so following them from a partial state yields its plan suffix in forward order
+        state_registry back_registry;
+        search_info back_info;
+        bucket_queue<open_entry> back_open;
+        vector<vector<int>> achievers; //atom -> operators adding it
+        pair_mutexes regression_mutexes; //partial states holding a mutex pair are inconsistent
+        vector<vector<state_id>> anchored; //lowest atom -> partial states, bidirectional meeting index
+        vector<vector<state_id>> expanded_with; //atom -> expanded forward states holding it, probed by new partial states
+        vector<uint8_t> meeting_indexed; //per forward state, already listed in expanded_with
+        vector<uint64_t> meeting_words; //scratch for the forward states probed by a partial state
+        state_id meeting_state = NO_STATE; //forward half of the cheapest meeting, NO_STATE if the start satisfies the partial state
+        state_id meeting_partial = NO_STATE;
+        int meeting_cost = INT32_MAX;
+        vector<int> start_costs; //relaxed cost of every atom from the start state, the regression heuristic
+        vector<int> relevant_stamp; //per operator, dedups relevant operators within one regression step
+        int regression_stamp = 0;
+        bool goal_found = false;
+
+        //alternates between the two lists, a state can sit in both so duplicates are caught by the closed check
+        open_entry get_next_from_open()
+        {
+            if(!preferred_open.empty() && (open_list.empty() || preferred_priority <= open_priority))
+            {
+                open_entry entry = preferred_open.top();
+                preferred_open.pop();
+                preferred_priority++;
+                preferred_expansions++;
+                return entry;
+            }
+            open_entry entry = open_list.top();
+            open_list.pop();
+            open_priority++;
+            return entry;
+        }
+
+        void add_to_open(const open_entry& entry, bool preferred = false)
+        {
+            open_list.push(entry);
+            if(preferred)
+            {
+                preferred_open.push(entry);
+            }
+            peak_open = max(peak_open, open_size());
+            // print_open();
+        }  
+
+        int open_size()
+        {
+            return open_list.size() + preferred_open.size();
+        }
+
+        void print_open()
+        {
+            bucket_queue<open_entry> temp_OL = open_list; 
+
+            printf("Open list: (%d)\n", (int)open_list.size());
+            while(!temp_OL.empty())
+            {
+                printf("\t");
+                print_state(temp_OL.top().id);
+                temp_OL.pop();
+            }
+        }
+
+        void print_state(state_id id)
+        {
+            printf("State %u, g %d, h %d: ", id, info.g[id], info.h[id]);
+            vector<uint64_t> buffer;
+            state_view state = registry.lookup_state(id, buffer);
+            for(int atom_id = 0; atom_id < index.size(); atom_id++)
+            {
+                if(state.test(atom_id))
+                {
+                    cout << index.get(atom_id).toString() << ", ";
+                }
+            }
+            printf("\n");
+        }
+
+        //printf for grounding and search progress, does nothing unless the configuration is verbose
+        void report(const char* format, ...) const
+        {
+            if(!options.verbose)
+            {
+                return;
+            }
+            va_list args;
+            va_start(args, format);
+            vprintf(format, args);
+            va_end(args);
+        }
+
+        //returns the h value of the input state, DEAD_END if the goal is unreachable even under the relaxation
+        int calculate_h(const state_view& state, relaxed_graph& engine)
+        {
+            switch(options.heuristic)
+            {
+                case H_ADD:
+                    return engine.evaluate(state, relaxed_graph::ADDITIVE);
+                case H_MAX:
+                    return engine.evaluate(state, relaxed_graph::MAXIMUM);
+                case FF:
+                    return engine.relaxed_plan(state);
+                case PDB:
+                    return pattern_databases.evaluate(state);
+                case GOAL_COUNT:
+                default:
+                    return goal_diff(state);
+            }
+        } 
+
+        int goal_diff(const state_view& state)
+        {
+            return state.count_missing(goal_condition);
+        }
+
+        vector<int> uset_to_vec(unordered_set<string> in_list)
+        {
+            vector<int> ret_vec; 
+            for(auto s : in_list)
+            {
+                ret_vec.push_back(symbol_table.intern(s));
+            }
+            return ret_vec;
+        }
+
+        void print_set(const vector<int>& v) 
+        {
+            static int count = 0;
+            count++;
+            cout << "combination number " << count << ": [ ";
+            for (int sym : v) 
+            { 
+                cout << symbol_table.name(sym) << " ";
+            }
+            cout << "] " << endl;
+        }
+
+        //generates every tuple of pairwise distinct symbols with tuple[i] drawn from domains[i]
+        void typed_combos(const vector<vector<int>>& domains, vector<vector<int>> &combos, vector<int>& temp)
+        {
+            if (temp.size() == domains.size()) {
+                combos.push_back(temp);
+                return;
+            }
+            for (int sym : domains[temp.size()]) 
+            {
+                if(find(temp.begin(), temp.end(), sym) != temp.end())
+                {
+                    continue;
+                }
+                temp.push_back(sym);
+                typed_combos(domains, combos, temp);
+                temp.pop_back();
+            }
+        }
+        
+        //true if the state has already been reached (open or closed) with a g-value no worse than g
+        bool is_duplicate(state_id id, int g)
+        {
+            return id != NO_STATE && info.g[id] <= g;
+        }
+
+        //records a path to the state as its best one, the caller has checked that it improves g
+        void record_path(state_id id, int g, state_id parent, int op)
+        {
+            info.g[id] = g;
+            info.parent[id] = parent;
+            info.creating_op[id] = op;
+        }
+
+        void add_to_closed(const open_entry& entry)
+        {
+            info.closed[entry.id] = 1;
+            expanded++;
+        }
+
+        //returns the id of the state, registering it (and growing the per-state tables) if it is new
+        template<typename State>
+        state_id register_state(const State& state, uint64_t hash)
+        {
+            pair<state_id, bool> result = registry.insert(state, hash);
+            if(result.second)
+            {
+                info.resize(registry.size());
+            }
+            return result.first;
+        }
+
+        //pushes a path to every successor of the state that is not closed with a better or equal g
+        void generate_neighbors(state_id parent_id, int parent_g)
+        {
+            state_view parent_state = registry.lookup_state(parent_id, expanded_words);
+            uint64_t parent_hash = registry.get_hash(parent_id);
+
+            vector<int> applicable;
+            successors.generate_applicable(parent_state, applicable);
+            if(options.partial_order_reduction)
+            {
+                pruning.prune(parent_state, applicable);
+            }
+            if(options.preferred_operators)
+            {
+                relaxation.relaxed_plan(parent_state, &helpful);
+                for(int op_ind : helpful)
+                {
+                    is_helpful[op_ind] = 1;
+                }
+            }
+            //the applicable operators always come from the successor generator on this thread, only their successors are
+            //hashed, duplicate-checked and evaluated in parallel
+            bool parallel = workers.size() > 1 && applicable.size() >= options.parallel_min_successors && !use_symmetries;
+            if(parallel)
+            {
+                parallel_expansions++;
+                evaluate_successors_in_parallel(parent_state, parent_hash, parent_g, applicable);
+            }
+            for(int i = 0; i < applicable.size(); i++) //iterating over the applicable ground operators only, in order
+            {
+                int op_ind = applicable[i];
+                //successor stays a parent+delta view until it survives the closed check, the heuristic sees the registered copy
+                successor_delta successor(parent_state, operators[op_ind]);
+                if(use_symmetries) //symmetric states share the registry entry of their representative
+                {
+                    state_view representative = canonical_form(successor);
+                    uint64_t hash = zobrist.hash(representative);
+                    if(!is_duplicate(registry.find(representative, hash), parent_g + 1))
+                    {
+                        open_successor(parent_id, parent_g, op_ind, register_state(representative, hash));
+                    }
+                    continue;
+                }
+                uint64_t hash;
+                if(parallel)
+                {
+                    if(evaluated[i].duplicate)
+                    {
+                        continue;
+                    }
+                    hash = evaluated[i].hash;
+                }
+                else
+                {
+                    hash = successor.hash(parent_hash, zobrist);
+                }
+                //repeated even after the parallel phase, an earlier operator of this expansion may have reached the state
+                if(is_duplicate(registry.find(successor, hash), parent_g + 1)) //only new states and better paths are opened
+                {
+                    continue;
+                }
+
+                state_id child = register_state(successor, hash);
+                if(parallel && info.h[child] < 0)
+                {
+                    info.h[child] = evaluated[i].h;
+                }
+                open_successor(parent_id, parent_g, op_ind, child);
+            }
+            for(int op_ind : helpful)
+            {
+                is_helpful[op_ind] = 0;
+            }
+        }
+
+        //hashes, duplicate-checks and evaluates the successors of one expansion on all workers. Each worker takes a
+        //contiguous slice of the applicable operators and only reads the registry, results land in evaluated by
+        //position so the merge into the open list stays in operator order
+        void evaluate_successors_in_parallel(const state_view& parent_state, uint64_t parent_hash, int parent_g, const vector<int>& applicable)
+        {
+            evaluated.resize(applicable.size());
+            bool evaluate_h = options.heuristic != LM_COUNT; //landmark progression needs the parent id, done when merging
+            workers.run([&](int worker)
+            {
+                int begin = applicable.size() * worker / workers.size();
+                int end = applicable.size() * (worker + 1) / workers.size();
+                vector<uint64_t> buffer(parent_state.num_words());
+                for(int i = begin; i < end; i++)
+                {
+                    successor_delta successor(parent_state, operators[applicable[i]]);
+                    successor_eval& result = evaluated[i];
+                    result.hash = successor.hash(parent_hash, zobrist);
+                    state_id existing = registry.find(successor, result.hash);
+                    result.duplicate = is_duplicate(existing, parent_g + 1);
+                    result.h = -1;
+                    if(!result.duplicate && evaluate_h && (existing == NO_STATE || info.h[existing] < 0))
+                    {
+                        successor.materialize(buffer.data());
+                        result.h = calculate_h(state_view(buffer.data(), buffer.size()), worker_relaxations[worker]);
+                    }
+                }
+            });
         }
-        return true;
-    }
-
-    friend ostream& operator<<(ostream& os, const GroundedAction& gac)
-    {
-        os << gac.toString() << " ";
-        return os;
-    }
 
-    string toString() const
-    {
-        string temp = "";
-        temp += this->name;
-        temp += "(";
-        for (string l : this->arg_values)
+        //h of a registered successor, computed once per state. Landmark progression runs for every new path to it
+        int evaluate_successor(state_id parent_id, state_id child)
         {
-            temp += l + ",";
+            if(options.heuristic == LM_COUNT)
+            {
+                state_view child_state = registry.lookup_state(child, lookup_words);
+                if(landmarks.progress(parent_id, child, child_state, info.h[child] < 0))
+                {
+                    info.h[child] = landmarks.count(child, child_state);
+                }
+            }
+            else if(info.h[child] < 0)
+            {
+                info.h[child] = calculate_h(registry.lookup_state(child, lookup_words), relaxation);
+            }
+            return info.h[child];
         }
-        temp = temp.substr(0, temp.length() - 1);
-        temp += ")";
-        return temp;
-    }
-};
 
-list<string> parse_symbols(string symbols_str)
-{
-    list<string> symbols;
-    size_t pos = 0;
-    string delimiter = ",";
-    while ((pos = symbols_str.find(delimiter)) != string::npos)
-    {
-        string symbol = symbols_str.substr(0, pos);
-        symbols_str.erase(0, pos + delimiter.length());
-        symbols.push_back(symbol);
-    }
-    symbols.push_back(symbols_str);
-    return symbols;
-}
+        //evaluates a registered successor if needed and opens the path to it unless it is a dead end
+        void open_successor(state_id parent_id, int parent_g, int op_ind, state_id child)
+        {
+            if(evaluate_successor(parent_id, child) == DEAD_END)
+            {
+                return;
+            }
+            if(false)
+            {
+                cout << "\nevaluating action " << operator_string(op_ind) << endl;
+                printf("\t   Adding as valid action/state!\n");
 
-Env* create_env(char* filename)
-{
-    ifstream input_file(filename);
-    Env* env = new Env();
-    regex symbolStateRegex("symbols:", regex::icase);
-    regex symbolRegex("([a-zA-Z0-9_, ]+) *");
-    regex initialConditionRegex("initialconditions:(.*)", regex::icase);
-    regex conditionRegex("(!?[A-Z][a-zA-Z_]*) *\\( *([a-zA-Z0-9_, ]+) *\\)");
-    regex goalConditionRegex("goalconditions:(.*)", regex::icase);
-    regex actionRegex("actions:", regex::icase);
-    regex precondRegex("preconditions:(.*)", regex::icase);
-    regex effectRegex("effects:(.*)", regex::icase);
-    int parser = SYMBOLS;
+                printf("\t   output is: ");
+                print_state(child);
+            }
 
-    unordered_set<Condition, ConditionHasher, ConditionComparator> preconditions;
-    unordered_set<Condition, ConditionHasher, ConditionComparator> effects;
-    string action_name;
-    string action_args;
+            if(options.preferred_operators && info.h[child] < best_h)
+            {
+                best_h = info.h[child];
+                preferred_priority -= options.preference_boost;
+            }
 
-    string line;
-    if (input_file.is_open())
-    {
-        while (getline(input_file, line))
-        {
-            string::iterator end_pos = remove(line.begin(), line.end(), ' ');
-            line.erase(end_pos, line.end());
+            record_path(child, parent_g + 1, parent_id, op_ind);
+            int weighted_h = weight*info.h[child];
+            open_entry entry{parent_g + 1 + weighted_h, weighted_h, parent_g + 1, child, parent_id, op_ind}; //assumes that all actions have equal cost
+            if(info.closed[child]) //better path to an expanded state
+            {
+                if(options.anytime) //ARA* does not re-expand within an iteration
+                {
+                    incons.push_back(entry);
+                    return;
+                }
+                info.closed[child] = 0; //reopened
+            }
+            add_to_open(entry, options.preferred_operators && is_helpful[op_ind]);
+        }
 
-            if (line == "")
-                continue;
+        string operator_string(int op_ind)
+        {
+            const ground_operator& op = operators[op_ind];
+            string temp = actions[op.action].get_name() + "(";
+            for(int arg : op.args)
+            {
+                temp += symbol_table.name(arg) + ",";
+            }
+            temp = temp.substr(0, temp.length() - 1);
+            temp += ")";
+            return temp;
+        }
 
-            if (parser == SYMBOLS)
+        void evaluate_neighbors(state_id parent_id)
+        {
+            if(false)
             {
-                smatch results;
-                if (regex_search(line, results, symbolStateRegex))
-                {
-                    line = line.substr(8);
-                    sregex_token_iterator iter(line.begin(), line.end(), symbolRegex, 0);
-                    sregex_token_iterator end;
+                printf("\n-------\nEvaluating ");
+                print_state(parent_id);
+            }
+            generate_neighbors(parent_id, info.g[parent_id]);
+        }
 
-                    env->add_symbols(parse_symbols(iter->str()));  // fixed
+        bool is_goal(state_id id)
+        {
+            return registry.lookup_state(id, lookup_words).contains_all(goal_condition);
+        }
 
-                    parser = INITIAL;
+        //predicates that no action effect adds or deletes, their truth is fixed by the initial conditions
+        void find_static_predicates()
+        {
+            unordered_set<int> changed;
+            for(const Action& act : actions)
+            {
+                for(const Atom& effect : act.get_lifted_adds())
+                {
+                    changed.insert(effect.predicate);
                 }
-                else
+                for(const Atom& effect : act.get_lifted_deletes())
                 {
-                    cout << "Symbols are not specified correctly." << endl;
-                    throw;
+                    changed.insert(effect.predicate);
                 }
             }
-            else if (parser == INITIAL)
+            for(int pred = 0; pred < predicate_table.size(); pred++)
             {
-                const char* line_c = line.c_str();
-                if (regex_match(line_c, initialConditionRegex))
+                if(changed.find(pred) == changed.end())
                 {
-                    const std::vector<int> submatches = { 1, 2 };
-                    sregex_token_iterator iter(
-                        line.begin(), line.end(), conditionRegex, submatches);
-                    sregex_token_iterator end;
+                    static_predicates.insert(pred);
+                }
+            }
+        }
 
-                    while (iter != end)
-                    {
-                        // name
-                        string predicate = iter->str();
-                        iter++;
-                        // args
-                        string args = iter->str();
-                        iter++;
+        bool is_static(const Atom& atom)
+        {
+            return static_predicates.find(atom.predicate) != static_predicates.end();
+        }
 
-                        if (predicate[0] == '!')
+        //infers a type for each action parameter from the static unary preconditions on it (e.g. Block(b)),
+        //and returns the symbols that satisfy all of them in the initial state. Untyped parameters range over every symbol.
+        vector<vector<int>> parameter_domains(const Action& act, const atom_set& init)
+        {
+            vector<vector<int>> domains(act.get_num_args());
+            for(int param = 0; param < act.get_num_args(); param++)
+            {
+                for(int sym : symbols)
+                {
+                    bool type_ok = true;
+                    for(const Atom& pc : act.get_lifted_preconditions())
+                    {
+                        if(pc.arity != 1 || pc.args[0] != -(param + 1) || static_predicates.find(pc.predicate) == static_predicates.end())
                         {
-                            env->remove_initial_condition(
-                                GroundedCondition(predicate.substr(1), parse_symbols(args)));
+                            continue;
                         }
-                        else
+                        Atom typed = pc;
+                        typed.args[0] = sym;
+                        finalize_atom(typed);
+                        if(init.find(typed) == init.end())
                         {
-                            env->add_initial_condition(
-                                GroundedCondition(predicate, parse_symbols(args)));
+                            type_ok = false;
+                            break;
                         }
                     }
-
-                    parser = GOAL;
-                }
-                else
-                {
-                    cout << "Initial conditions not specified correctly." << endl;
-                    throw;
+                    if(type_ok)
+                    {
+                        domains[param].push_back(sym);
+                    }
                 }
             }
-            else if (parser == GOAL)
+            return domains;
+        }
+
+        vector<vector<int>> generate_typed_combos(const Action& act, const atom_set& init)
+        {
+            vector<vector<int>> combinations;
+            vector<int> tempo;
+            typed_combos(parameter_domains(act, init), combinations, tempo);
+
+            if(false)
             {
-                const char* line_c = line.c_str();
-                if (regex_match(line_c, goalConditionRegex))
+                printf("Complete.\n");
+                for(int i = 0; i < combinations.size(); ++i)
                 {
-                    const std::vector<int> submatches = { 1, 2 };
-                    sregex_token_iterator iter(
-                        line.begin(), line.end(), conditionRegex, submatches);
-                    sregex_token_iterator end;
+                    print_set(combinations[i]);
+                }
+            }
 
-                    while (iter != end)
-                    {
-                        // name
-                        string predicate = iter->str();
-                        iter++;
-                        // args
-                        string args = iter->str();
-                        iter++;
+            return combinations;
+        }
 
-                        if (predicate[0] == '!')
-                        {
-                            env->remove_goal_condition(
-                                GroundedCondition(predicate.substr(1), parse_symbols(args)));
-                        }
-                        else
-                        {
-                            env->add_goal_condition(
-                                GroundedCondition(predicate, parse_symbols(args)));
-                        }
-                    }
+        tuple<string, list<string>> op_to_pair(int op_ind)
+        {
+            list<string> arg_names;
+            for(int arg : operators[op_ind].args)
+            {
+                arg_names.push_back(symbol_table.name(arg));
+            }
+            return tuple<string, list<string>>(actions[operators[op_ind].action].get_name(), arg_names);
+        }
 
-                    parser = ACTIONS;
+        void generate_plan(state_id goal_id)
+        {
+            if(NO_STATE != goal_id)
+            {
+                vector<int> plan_ops;
+                vector<state_id> path{goal_id};
+                for(state_id current = goal_id; info.parent[current] != NO_STATE; current = info.parent[current])
+                {
+                    plan_ops.push_back(info.creating_op[current]);
+                    path.push_back(info.parent[current]);
                 }
-                else
+                reverse(plan_ops.begin(), plan_ops.end());
+                reverse(path.begin(), path.end());
+                if(use_symmetries)
                 {
-                    cout << "Goal conditions not specified correctly." << endl;
-                    throw;
+                    plan_ops = unfold_symmetric_plan(path, plan_ops);
                 }
+                generate_plan(plan_ops);
             }
-            else if (parser == ACTIONS)
+            else 
             {
-                const char* line_c = line.c_str();
-                if (regex_match(line_c, actionRegex))
+                report("No goal found Failed to generate plan!\n");
+            }
+        }
+
+        //representative of a state under the object symmetries, valid until the next call. applied receives the generators
+        //that turned the state into it
+        template<typename State>
+        state_view canonical_form(const State& state, vector<int>* applied = nullptr)
+        {
+            canonical.resize(state.num_words());
+            materialize(state, canonical.data());
+            if(symmetries.canonicalize(canonical.data(), canonical.size(), symmetry_scratch, applied) > 0 && applied == nullptr)
+            {
+                symmetric_successors++;
+            }
+            return state_view(canonical.data(), canonical.size());
+        }
+
+        static void materialize(const successor_delta& state, uint64_t* out)
+        {
+            state.materialize(out);
+        }
+
+        static void materialize(const state_view& state, uint64_t* out)
+        {
+            copy(state.data(), state.data() + state.num_words(), out);
+        }
+
+        //the operators of a path through representatives act on the representatives. Replaying the path from the real
+        //start state, perm maps the symbols of the current representative to those of the real state, so each operator is
+        //carried over by renaming its arguments and perm is extended by the generators that produced the next one
+        vector<int> unfold_symmetric_plan(const vector<state_id>& path, const vector<int>& plan_ops)
+        {
+            map<vector<int>, int> lookup; //(action, args...) -> operator
+            for(int op_ind = 0; op_ind < operators.size(); op_ind++)
+            {
+                vector<int> key{operators[op_ind].action};
+                key.insert(key.end(), operators[op_ind].args.begin(), operators[op_ind].args.end());
+                lookup[key] = op_ind;
+            }
+            vector<int> perm(symbol_table.size());
+            for(int sym = 0; sym < perm.size(); sym++)
+            {
+                perm[sym] = sym;
+            }
+            vector<int> applied;
+            auto extend = [&]()
+            {
+                vector<int> next(perm.size());
+                for(int sym = 0; sym < perm.size(); sym++)
                 {
-                    parser = ACTION_DEFINITION;
+                    int image = sym;
+                    for(int j = applied.size() - 1; j >= 0; j--) //generators are transpositions, undone in reverse order
+                    {
+                        image = symmetries.apply(applied[j], image);
+                    }
+                    next[sym] = perm[image];
                 }
-                else
+                perm = next;
+                applied.clear();
+            };
+            canonical_form(start_condition, &applied);
+            extend();
+            vector<int> real_ops;
+            vector<uint64_t> buffer;
+            for(int i = 0; i < plan_ops.size(); i++)
+            {
+                const ground_operator& op = operators[plan_ops[i]];
+                vector<int> key{op.action};
+                for(int arg : op.args)
                 {
-                    cout << "Actions not specified correctly." << endl;
-                    throw;
+                    key.push_back(perm[arg]);
                 }
+                real_ops.push_back(lookup.at(key));
+                canonical_form(successor_delta(registry.lookup_state(path[i], buffer), op), &applied);
+                extend();
             }
-            else if (parser == ACTION_DEFINITION)
+            return real_ops;
+        }
+
+        //turns a sequence of ground operators into the final plan
+        void generate_plan(const vector<int>& plan_ops)
+        {
+            vector<tuple<string, list<string>>> plan_vec; 
+            report("Populating path...\n");
+            report("goal count is %d\n", (int)plan_ops.size());
+            
+            for(int op_ind : plan_ops)
             {
-                const char* line_c = line.c_str();
-                if (regex_match(line_c, conditionRegex))
-                {
-                    const std::vector<int> submatches = { 1, 2 };
-                    sregex_token_iterator iter(
-                        line.begin(), line.end(), conditionRegex, submatches);
-                    sregex_token_iterator end;
-                    // name
-                    action_name = iter->str();
-                    iter++;
-                    // args
-                    action_args = iter->str();
-                    iter++;
+                tuple<string, list<string>> act_pair = op_to_pair(op_ind);
+                plan_vec.push_back(act_pair);
+                // cout << operator_string(op_ind) << endl;
+            }
 
-                    parser = ACTION_PRECONDITION;
+            //generating list of groundedActions
+            for(auto ac_pr: plan_vec)
+            {
+                final_plan.push_back(GroundedAction(get<0>(ac_pr), get<1>(ac_pr)));
+            }
+            report("Population complete (%d expanded states) \n", expanded);
+        }
+
+        //indexes every ground atom reachable from the start under the delete relaxation, then builds the start/goal bitsets
+        //and grounds every action instance whose preconditions are reachable. Symbol combinations are only enumerated here.
+        void ground_task(const unordered_set<Condition, ConditionHasher, ConditionComparator>& start, 
+            const unordered_set<Condition, ConditionHasher, ConditionComparator>& goal)
+        {
+            atom_set init;
+            atom_set static_atoms; //true static atoms, these never enter a search state
+            find_static_predicates();
+            for(const Condition& cond : start)
+            {
+                init.insert(cond.get_atom());
+                if(is_static(cond.get_atom()))
+                {
+                    static_atoms.insert(cond.get_atom());
                 }
                 else
                 {
-                    cout << "Action not specified correctly." << endl;
-                    throw;
+                    index.add(cond.get_atom());
                 }
             }
-            else if (parser == ACTION_PRECONDITION)
+            for(Action& act : actions)
+            {
+                act.mark_static_predicates(static_predicates);
+            }
+            vector<vector<vector<int>>> candidates(actions.size()); //type-consistent argument tuples per action
+            int num_candidates = 0;
+            for(int act_ind = 0; act_ind < actions.size(); act_ind++)
+            {
+                candidates[act_ind] = generate_typed_combos(actions[act_ind], init);
+                num_candidates += candidates[act_ind].size();
+            }
+
+            bool changed = true;
+            while(changed)
             {
-                const char* line_c = line.c_str();
-                if (regex_match(line_c, precondRegex))
+                changed = false;
+                for(int act_ind = 0; act_ind < actions.size(); act_ind++)
                 {
-                    const std::vector<int> submatches = { 1, 2 };
-                    sregex_token_iterator iter(
-                        line.begin(), line.end(), conditionRegex, submatches);
-                    sregex_token_iterator end;
-
-                    while (iter != end)
+                    for(const vector<int>& input : candidates[act_ind])
                     {
-                        // name
-                        string predicate = iter->str();
-                        iter++;
-                        // args
-                        string args = iter->str();
-                        iter++;
-
-                        bool truth;
-
-                        if (predicate[0] == '!')
-                        {
-                            predicate = predicate.substr(1);
-                            truth = false;
-                        }
-                        else
+                        if(actions[act_ind].preconditions_reachable(index, static_atoms, input))
                         {
-                            truth = true;
+                            changed |= actions[act_ind].index_adds(index, input);
                         }
-
-                        Condition precond(predicate, parse_symbols(args), truth);
-                        preconditions.insert(precond);
                     }
-
-                    parser = ACTION_EFFECT;
                 }
-                else
+            }
+
+            //unreachable goals still get a bit so that the goal mask can express them. Static goals are settled here:
+            //true ones are dropped, false ones keep their (never set) bit
+            vector<Atom> search_goals;
+            for(const Condition& cond : goal)
+            {
+                if(!is_static(cond.get_atom()) || static_atoms.find(cond.get_atom()) == static_atoms.end())
                 {
-                    cout << "Precondition not specified correctly." << endl;
-                    throw;
+                    index.add(cond.get_atom());
+                    search_goals.push_back(cond.get_atom());
                 }
             }
-            else if (parser == ACTION_EFFECT)
+
+            start_condition = state_bits(index.size());
+            for(const Condition& cond : start)
             {
-                const char* line_c = line.c_str();
-                if (regex_match(line_c, effectRegex))
+                if(!is_static(cond.get_atom()))
                 {
-                    const std::vector<int> submatches = { 1, 2 };
-                    sregex_token_iterator iter(
-                        line.begin(), line.end(), conditionRegex, submatches);
-                    sregex_token_iterator end;
+                    start_condition.set(index.lookup(cond.get_atom()));
+                }
+            }
+            goal_condition = state_bits(index.size());
+            for(const Atom& goal_atom : search_goals)
+            {
+                goal_condition.set(index.lookup(goal_atom));
+            }
+            zobrist.init(index.size());
 
-                    while (iter != end)
+            for(int act_ind = 0; act_ind < actions.size(); act_ind++)
+            {
+                for(const vector<int>& input : candidates[act_ind])
+                {
+                    if(actions[act_ind].preconditions_reachable(index, static_atoms, input))
                     {
-                        // name
-                        string predicate = iter->str();
-                        iter++;
-                        // args
-                        string args = iter->str();
-                        iter++;
+                        operators.push_back(actions[act_ind].ground(act_ind, index, input));
+                    }
+                }
+            }
+            successors.init(operators);
 
-                        bool truth;
+            task->init_atoms.assign(init.begin(), init.end());
+            for(const Condition& cond : goal)
+            {
+                task->goal_atoms.push_back(cond.get_atom());
+            }
+            report("Indexed %d reachable atoms (%d words per state, %d static atoms removed), %d ground operators from %d typed candidates\n", 
+                index.size(), start_condition.num_words(), (int)static_atoms.size(), (int)operators.size(), num_candidates);
+            report("Successor generator has %d decision nodes\n", successors.size());
+        }
 
-                        if (predicate[0] == '!')
-                        {
-                            predicate = predicate.substr(1);
-                            truth = false;
-                        }
-                        else
+        //object symmetries of the grounded task. The constants of the action schemas are fixed points
+        void detect_symmetries()
+        {
+            vector<int> constants;
+            for(const Action& act : actions)
+            {
+                for(const vector<Atom>* lifted : {&act.get_lifted_preconditions(), &act.get_lifted_adds(), &act.get_lifted_deletes()})
+                {
+                    for(const Atom& atom : *lifted)
+                    {
+                        for(int k = 0; k < atom.arity; k++)
                         {
-                            truth = true;
+                            if(atom.args[k] >= 0 && find(constants.begin(), constants.end(), atom.args[k]) == constants.end())
+                            {
+                                constants.push_back(atom.args[k]);
+                            }
                         }
-
-                        Condition effect(predicate, parse_symbols(args), truth);
-                        effects.insert(effect);
                     }
-
-                    env->add_action(
-                        Action(action_name, parse_symbols(action_args), preconditions, effects, env->get_symbols()));
-
-                    preconditions.clear();
-                    effects.clear();
-                    parser = ACTION_DEFINITION;
-                }
-                else
-                {
-                    cout << "Effects not specified correctly." << endl;
-                    throw;
                 }
             }
+            symmetries.detect(symbols, constants, task->init_atoms, task->goal_atoms, index, operators);
+            task->symmetries_detected = true;
+            report("Found %d object symmetry generators\n", symmetries.size());
         }
-        input_file.close();
-    }
-
-    else
-        cout << "Unable to open file";
-
-    return env;
-}
 
+        //mutex groups and the finite-domain encoding over them
+        void synthesize_mutexes()
+        {
+            mutexes.synthesize(actions, operators, index, start_condition);
+            vector<vector<int>> cover;
+            vector<uint8_t> cover_exactly_one;
+            mutexes.partition(cover, cover_exactly_one);
+            packer.init(cover, cover_exactly_one, index.size());
+            task->mutexes_synthesized = true;
+            report("Synthesized %d mutex groups, %d finite-domain variables take %d bits (%d words per state instead of %d)\n", 
+                mutexes.size(), packer.num_variables(), packer.bits(), packer.packed_words(), start_condition.num_words());
+        }
 
-class symbo_planner
-{
-    private:
-        class symbo_node
-        {
-            protected:
-                string prev_action;
-                list<string> prev_action_inputs;
-                vector<symbo_node*> children;
-                symbo_node* parent;
-                int id = -1;
-                unordered_set<Condition, ConditionHasher, ConditionComparator> state;
-                int cost = 0; // g value, cumulative
-                int h = 0; 
-                int f = 0; 
-                bool is_start = false;
-                int count_id;  
-            
-            public: 
-                symbo_node()
+        //per-planner heuristic data and search containers over the grounded task
+        void prepare_search()
+        {
+            relaxation.init(operators, index.size(), goal_condition);
+            is_helpful.assign(operators.size(), 0);
+            workers.init(max(options.threads, 1));
+            worker_relaxations.assign(workers.size(), relaxation);
+            if(options.heuristic == LM_COUNT)
+            {
+                landmarks.discover(operators, index.size(), start_condition, goal_condition);
+                report("Found %d landmarks with %d greedy-necessary orderings\n", landmarks.size(), landmarks.orderings());
+            }
+            if(options.heuristic == PDB)
+            {
+                pattern_databases.build(operators, index.size(), goal_condition, min(options.pdb_pattern_size, 20));
+                report("Built %d pattern databases in %d additive groups (%.1f KB)\n", pattern_databases.size(), 
+                    pattern_databases.num_groups(), pattern_databases.memory_bytes() / 1024.0);
+            }
+            if(options.partial_order_reduction)
+            {
+                pruning.init(operators, index.size(), goal_condition);
+                report("Stubborn sets over %d interfering operator pairs\n", pruning.interference_pairs() / 2);
+            }
+            use_symmetries = false;
+            if(options.symmetry_reduction && (options.search == HDA_STAR || options.search == EHC || options.search == REGRESSION 
+                || options.search == BIDIRECTIONAL || options.heuristic == LM_COUNT || options.partial_order_reduction))
+            {
+                report("Warning: symmetry reduction is ignored, it is only used by best-first and greedy best-first search without "
+                    "landmarks or stubborn sets\n");
+            }
+            else if(options.symmetry_reduction)
+            {
+                if(!task->symmetries_detected)
                 {
-                    //do nothing
+                    detect_symmetries();
                 }
-                symbo_node(string prev_action_in,
-                    list<string> prev_action_inputs_in, 
-                    symbo_node* parent_in, 
-                    unordered_set<Condition, ConditionHasher, ConditionComparator> state_in, 
-                    int id, int count)
+                use_symmetries = symmetries.size() > 0;
+            }
+            if(use_symmetries && options.threads > 1)
+            {
+                report("Warning: symmetry reduction evaluates successors on the calling thread, the other %d threads stay idle\n", 
+                    options.threads - 1);
+            }
+            if(options.search == REGRESSION || options.search == BIDIRECTIONAL)
+            {
+                achievers.assign(index.size(), vector<int>());
+                for(int op_ind = 0; op_ind < operators.size(); op_ind++)
+                {
+                    for(int atom_id : operators[op_ind].add)
                     {
-                        this->prev_action = prev_action_in;
-                        this->prev_action_inputs = prev_action_inputs_in;
-                        this->state = state_in;
-                        this->parent = parent_in;
-                        this->id = id;
-                        this->count_id = count; 
+                        achievers[atom_id].push_back(op_ind);
                     }
-                
-                int get_count()
-                {
-                    return this->count_id;
                 }
-                void update_f()
+                relevant_stamp.assign(operators.size(), 0);
+                if(regression_mutexes.init(operators, index.size(), start_condition))
                 {
-                    this->f = cost + h; 
+                    report("Regression prunes partial states with %d mutex pairs\n", regression_mutexes.num_mutexes());
                 }
-                
-                void set_cost(int in_cost)
+                else
                 {
-                    this->cost = in_cost; 
-                    update_f();
+                    report("Too many atoms (%d) for the pairwise mutex table, regression only drops partial states with an atom "
+                        "the start cannot reach\n", index.size());
                 }
+                back_registry.init(start_condition.num_words());
+                back_open.set_lifo(options.lifo_ties);
+            }
+            if(options.finite_domain_encoding && !task->mutexes_synthesized)
+            {
+                synthesize_mutexes();
+            }
+            registry.init(start_condition.num_words(), options.finite_domain_encoding ? &packer : nullptr);
+            open_list.set_lifo(options.lifo_ties);
+            preferred_open.set_lifo(options.lifo_ties);
+        }
 
-                void set_h(int in_h)
-                {
-                    this->h = in_h; 
-                    update_f();
-                }
+        void print_pruning()
+        {
+            if(options.partial_order_reduction && pruning.applicable_seen() > 0)
+            {
+                report("Stubborn sets pruned %d of %d applicable operators (%.1f%%)\n", pruning.pruned(), pruning.applicable_seen(), 
+                    100.0 * pruning.pruned() / pruning.applicable_seen());
+                pruning.reset_counts();
+            }
+        }
 
-                void add_child(symbo_node* child_in)
+        //drops every state of the finished search at once, the plan has already been extracted by then
+        void release_search_memory()
+        {
+            if(registry.size() > 0)
+            {
+                report("Search registered %d states in %.1f KB (%.1f KB state pool, %.1f KB search info)\n", registry.size(), 
+                    (registry.memory_bytes() + info.memory_bytes()) / 1024.0, registry.memory_bytes() / 1024.0, info.memory_bytes() / 1024.0);
+                report("Peak open list size was %d entries\n", peak_open);
+                if(workers.size() > 1)
                 {
-                    children.push_back(child_in);
+                    report("%d of %d expansions evaluated on %d workers\n", parallel_expansions, expanded, workers.size());
                 }
+            }
+            if(options.heuristic == LM_COUNT)
+            {
+                report("Landmark status used %.1f KB\n", landmarks.memory_bytes() / 1024.0);
+            }
+            print_pruning();
+            if(use_symmetries)
+            {
+                report("Symmetry reduction replaced %d generated states by a symmetric representative\n", symmetric_successors);
+                symmetric_successors = 0;
+            }
+            open_list.clear();
+            preferred_open.clear();
+            incons.clear();
+            back_registry.clear();
+            back_info.clear();
+            back_open.clear();
+            anchored = vector<vector<state_id>>();
+            expanded_with = vector<vector<state_id>>();
+            meeting_indexed.clear();
+            meeting_state = NO_STATE;
+            meeting_partial = NO_STATE;
+            meeting_cost = INT32_MAX;
+            registry.clear();
+            info.clear();
+            landmarks.clear();
+            peak_open = 0;
+            parallel_expansions = 0;
+            expanded = 0;
+        }
 
-                unordered_set<Condition, ConditionHasher, ConditionComparator> get_state()
-                {
-                    return state;
-                }
+        void start_timer()
+        {
+            startTime = std::chrono::system_clock::now();
+        }
+        
+        bool cancelled() const
+        {
+            return options.cancel != nullptr && options.cancel->load(memory_order_relaxed);
+        }
 
-                string get_prev_action()
-                {
-                    return prev_action;
-                }
+        double elapsed_seconds()
+        {
+            return std::chrono::duration<double>(std::chrono::system_clock::now() - startTime).count();
+        }
+
+        double cumulative_time()
+        {
+            std::chrono::time_point<std::chrono::system_clock> curTime = std::chrono::system_clock::now();
+            return ceil(std::chrono::duration_cast<std::chrono::milliseconds>(curTime - startTime).count()/1000);
+        }
 
-                list<string> get_prev_inputs()
+
+
+
+        symbo_planner(shared_ptr<grounded_task> task_in, planner_options options_in) : task(task_in), index(task->index), 
+            zobrist(task->zobrist), start_condition(task->start_condition), goal_condition(task->goal_condition), symbols(task->symbols), 
+            actions(task->actions), operators(task->operators), static_predicates(task->static_predicates), successors(task->successors), 
+            symmetries(task->symmetries), mutexes(task->mutexes), packer(task->packer), options(options_in)
+        {
+        }
+
+    public: 
+        symbo_planner(unordered_set<Condition, ConditionHasher, ConditionComparator> start, 
+            unordered_set<Condition, ConditionHasher, ConditionComparator> goal, 
+            unordered_set<string> sym, 
+            unordered_set<Action, ActionHasher, ActionComparator> actions_in,
+            planner_options options_in = planner_options()) : symbo_planner(make_shared<grounded_task>(), options_in)
+            {
+                this->symbols = uset_to_vec(sym);
+                sort(symbols.begin(),symbols.end() ); //sorts symbol ids so that grounding order is deterministic
+                for(const Action& act : actions_in)
                 {
-                    return prev_action_inputs;
+                    this->actions.push_back(act);
                 }
+                ground_task(start, goal);
+                prepare_search();
+            }
+
+        //searches the task grounded by other with its own configuration
+        symbo_planner(const symbo_planner& other, planner_options options_in) : symbo_planner(other.task, options_in)
+            {
+                prepare_search();
+            }
 
-                void print_full_prev_action_string()
+        //races one planner per configuration, each on its own thread over this planner's grounded task. With first_plan
+        //the first plan found cancels the others, otherwise they run until the budget and the cheapest plan wins
+        void run_portfolio(const vector<planner_options>& configs, bool first_plan, double budget_seconds)
+        {
+            start_timer();
+            atomic<bool> cancel(false);
+            atomic<int> running(configs.size());
+            mutex result_lock;
+            int best_cost = INT32_MAX;
+            int winner = -1;
+            int winner_expanded = 0;
+            double winner_seconds = 0;
+            vector<unique_ptr<symbo_planner>> members;
+            for(int i = 0; i < configs.size(); i++)
+            {
+                planner_options config = configs[i];
+                config.cancel = &cancel;
+                config.verbose = false; //only the summary of the winner is printed, below
+                config.plan_callback = [&, i](const list<GroundedAction>& plan, int cost)
                 {
-                    string prev_action_full = this->get_prev_action();
-                    int substring_ind = prev_action_full.find("(");
-                    cout << prev_action_full.substr(0,substring_ind) << "(";
-                    for(auto in: this->prev_action_inputs)
+                    lock_guard<mutex> guard(result_lock);
+                    if(cost < best_cost)
+                    {
+                        best_cost = cost;
+                        winner = i;
+                        winner_expanded = members[i]->expanded; //runs on the member's thread, before its statistics are reset
+                        winner_seconds = elapsed_seconds();
+                        final_plan = plan;
+                    }
+                    if(first_plan)
                     {
-                        cout << in << ",";
-                    } 
-                    cout << ")     (" << this->get_h() << ")" << endl;
+                        cancel.store(true);
+                    }
+                };
+                members.emplace_back(new symbo_planner(*this, config));
+            }
 
-                }
-                vector<symbo_node*> get_children()
+            vector<thread> threads;
+            for(int i = 0; i < members.size(); i++)
+            {
+                threads.emplace_back([&, i]()
                 {
-                    return children;
-                }
+                    members[i]->generate_tree();
+                    running.fetch_sub(1);
+                });
+            }
+            while(running.load() > 0 && elapsed_seconds() < budget_seconds)
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            cancel.store(true); //no-op if a plan already cancelled everything
+            for(thread& t : threads)
+            {
+                t.join();
+            }
+
+            if(winner >= 0)
+            {
+                goal_found = true;
+                printf("Portfolio: configuration %d won with plan cost %d after %d expansions and %.3fs\n", winner, best_cost, 
+                    winner_expanded, winner_seconds);
+            }
+            else
+            {
+                printf("Portfolio: no configuration found a plan within %.1fs\n", budget_seconds);
+            }
+        }
 
-                symbo_node* get_parent()
+        //expands until a goal is expanded, nothing left can beat the incumbent plan cost, or the anytime deadline passes
+        state_id search_iteration(int incumbent_cost)
+        {
+            while(open_size() != 0 && !cancelled())
+            {
+                if(options.anytime && incumbent_cost != INT32_MAX && elapsed_seconds() > options.deadline_seconds)
                 {
-                    return parent;
+                    return NO_STATE;
                 }
-
-                int get_h()
+                open_entry current = get_next_from_open();
+                //stale entries (a better path was opened since) and copies already expanded from the other list
+                if(current.g > info.g[current.id] || info.closed[current.id] || current.g >= incumbent_cost)
                 {
-                    return h;
+                    continue;
                 }
-
-                int get_f()
+                if(current.f >= incumbent_cost) //the incumbent is within the bound of this weight
                 {
-                    return f; 
+                    add_to_open(current);
+                    return NO_STATE;
                 }
-
-                int get_g()
+                add_to_closed(current);
+                evaluate_neighbors(current.id);
+                if(is_goal(current.id))
                 {
-                    return cost;
+                    return current.id;
                 }
+            }
+            return NO_STATE;
+        }
 
-                int get_cost()
+        //marks the helpful actions of state for the preferred list, undone by clear_helpful
+        void mark_helpful(const state_view& state)
+        {
+            if(options.preferred_operators)
+            {
+                relaxation.relaxed_plan(state, &helpful);
+                for(int op_ind : helpful)
                 {
-                    return get_g();
+                    is_helpful[op_ind] = 1;
                 }
-                
-                bool operator==(const symbo_node &obj2) const
+            }
+        }
+
+        void clear_helpful()
+        {
+            for(int op_ind : helpful)
+            {
+                is_helpful[op_ind] = 0;
+            }
+            helpful.clear();
+        }
+
+        //lazy greedy best-first search: successors enter the open list as (parent, operator) keyed by the parent's h and
+        //are only built and evaluated when popped. States are never reopened, the first goal expanded is returned
+        state_id lazy_search_iteration()
+        {
+            vector<int> applicable;
+            while(open_size() != 0 && !cancelled())
+            {
+                open_entry current = get_next_from_open();
+                state_id id = current.id;
+                if(id == NO_STATE) //deferred successor
                 {
-                    if(this->state == obj2.state)
+                    successor_delta successor(registry.lookup_state(current.parent, expanded_words), operators[current.op]);
+                    if(use_symmetries)
                     {
-                        return true;
+                        state_view representative = canonical_form(successor);
+                        id = register_state(representative, zobrist.hash(representative));
                     }
-                        return false;
-                }
-
-                void print_state()
-                {
-                    // sort(state.begin(), state.end());
-                    printf("Node %d, State: ", this->id);
-                    for(auto cond: state)
+                    else
+                    {
+                        id = register_state(successor, successor.hash(registry.get_hash(current.parent), zobrist));
+                    }
+                    if(info.closed[id])
+                    {
+                        continue;
+                    }
+                    if(current.g < info.g[id])
+                    {
+                        record_path(id, current.g, current.parent, current.op);
+                    }
+                    if(evaluate_successor(current.parent, id) == DEAD_END)
                     {
-                        cout << cond.toString() << ", ";
+                        info.closed[id] = 1;
+                        continue;
                     }
-                    printf("\n");
                 }
-
-                int get_id()
+                else if(info.closed[id])
                 {
-                    return this->id;
+                    continue;
                 }
-
-                bool get_is_start()
+                info.closed[id] = 1;
+                expanded++;
+                if(is_goal(id))
                 {
-                    return this->is_start;
+                    return id;
                 }
 
-                void set_is_start(bool start)
+                if(options.preferred_operators && info.h[id] < best_h)
                 {
-                    this->is_start = start;
+                    best_h = info.h[id];
+                    preferred_priority -= options.preference_boost;
                 }
-        };
-
-        struct compareFvals
-        {
-            bool operator()(symbo_node* const& left, symbo_node* const& right) const
-            {
-                if(left->get_f() != right->get_f())
+                state_view state = registry.lookup_state(id, expanded_words);
+                applicable.clear();
+                successors.generate_applicable(state, applicable);
+                if(options.partial_order_reduction)
                 {
-                    return left->get_f() > right->get_f();
+                    pruning.prune(state, applicable);
                 }
-                else
+                mark_helpful(state);
+                for(int op_ind : applicable)
                 {
-                    //tie-breaking if f is the same
-                    return left->get_h() < right->get_h();
+                    add_to_open(open_entry{info.h[id], 0, info.g[id] + 1, NO_STATE, id, op_ind}, options.preferred_operators && is_helpful[op_ind]);
                 }
-            }     
-        };
-        // sets which automatically sorts 
-        // set<symbo_node*, compareFvals> open_list;
-        std::priority_queue<symbo_node*, std::vector<symbo_node*>, compareFvals> open_list; 
-        unordered_set<symbo_node*> closed_list;
-        unordered_set<symbo_node*> tree; //not really used.
-        unordered_set<Condition, ConditionHasher, ConditionComparator> start_condition;
-        unordered_set<Condition, ConditionHasher, ConditionComparator> goal_condition; 
-        vector<string> symbols; //vector instead of unordered set for ease of indexing in generating combinations
-        unordered_set<Action, ActionHasher, ActionComparator> actions;
-        list<GroundedAction> final_plan;
-        chrono::time_point<chrono::system_clock> startTime;
-        bool is_heuristic = false;
-        int goal_ct = -1;
-        symbo_planner* heuristic_planner;
-        bool goal_found = false;
-        int id_tracker = 0; 
-
-        symbo_node* get_next_from_open()
-        {
-            //pointer dissociates from iterator
-            // symbo_node* node = *open_list.begin();
-            
-            //erases value extracted from open list
-            // open_list.erase(open_list.begin());
-
-            symbo_node* node = open_list.top();
-            open_list.pop();
-            return node;
-        }
-
-        void add_to_open(symbo_node* node)
-        {
-        //     auto result = open_list.insert(node);
-        //     assert(result.first != open_list.end()); // it's a valid iterator
-        //     // assert(*result.first == node);
-        //     if (result.second)
-        //     {
-        //         std::cout << "insert done\n";
-        //     }
-        //     else 
-        //    {
-        //         std::cout << "insert FIALED\n";
-        //    }
-            open_list.push(node);
-            // print_open();
-        }  
+                clear_helpful();
+            }
+            return NO_STATE;
+        }
 
-        void print_open()
+        //enforced hill-climbing: breadth-first search from the current state until a strictly better h (or a goal) is
+        //found, then commits to the path there. Breadth-first parents are kept apart from search_info so that committed
+        //states revisited later keep theirs. Returns false if a breadth-first search is exhausted without improvement
+        bool enforced_hill_climbing(state_id start, vector<int>& plan_ops)
         {
-            std::priority_queue<symbo_node*, std::vector<symbo_node*>, compareFvals> temp_OL; 
-
-            // printf("Open list: (%d)\n", open_list.size());
-            // for(auto node: open_list)
-            // {
-            //     printf("\t");
-            //     node->print_state();
-            // }
-            
-            while(!temp_OL.empty())
+            state_id current = start;
+            vector<state_id> queue;
+            vector<state_id> bfs_parent;
+            vector<int> bfs_op;
+            vector<int> visited; //stamp of the last breadth-first search that reached the state
+            vector<int> applicable;
+            int stamp = 0;
+            while(!is_goal(current))
             {
-                printf("\t");
-                temp_OL.top()->print_state();
-                temp_OL.pop();
+                stamp++;
+                visited.resize(registry.size(), 0);
+                bfs_parent.resize(registry.size());
+                bfs_op.resize(registry.size());
+                visited[current] = stamp;
+                queue.assign(1, current);
+                state_id improved = NO_STATE;
+                for(int i = 0; i < queue.size() && improved == NO_STATE && !cancelled(); i++)
+                {
+                    state_id id = queue[i];
+                    state_view state = registry.lookup_state(id, expanded_words);
+                    uint64_t hash = registry.get_hash(id);
+                    expanded++;
+                    applicable.clear();
+                    successors.generate_applicable(state, applicable);
+                    mark_helpful(state);
+                    stable_partition(applicable.begin(), applicable.end(), [&](int op_ind) { return is_helpful[op_ind]; });
+                    clear_helpful();
+                    for(int op_ind : applicable)
+                    {
+                        successor_delta successor(state, operators[op_ind]);
+                        state_id child = register_state(successor, successor.hash(hash, zobrist));
+                        if(child >= visited.size())
+                        {
+                            visited.resize(registry.size(), 0);
+                            bfs_parent.resize(registry.size());
+                            bfs_op.resize(registry.size());
+                        }
+                        if(visited[child] == stamp)
+                        {
+                            continue;
+                        }
+                        visited[child] = stamp;
+                        bfs_parent[child] = id;
+                        bfs_op[child] = op_ind;
+                        int child_h = evaluate_successor(id, child);
+                        if(child_h == DEAD_END)
+                        {
+                            continue;
+                        }
+                        if(child_h < info.h[current] || is_goal(child))
+                        {
+                            improved = child;
+                            break;
+                        }
+                        queue.push_back(child);
+                    }
+                }
+                if(improved == NO_STATE)
+                {
+                    return false;
+                }
+                size_t segment_start = plan_ops.size();
+                for(state_id id = improved; id != current; id = bfs_parent[id])
+                {
+                    plan_ops.push_back(bfs_op[id]);
+                }
+                reverse(plan_ops.begin() + segment_start, plan_ops.end());
+                current = improved;
             }
+            return true;
         }
 
-        void heuristic_reset(symbo_node* start)
+        //h_add (h_max for H_MAX) of a partial state from the start, computed from one relaxed exploration of the start
+        int regression_h(const state_view& partial)
         {
-            closed_list.clear();
-            tree.clear();
-            start_condition = start->get_state();
-            start_timer();
-            is_heuristic = true;
-            id_tracker = 0; 
-
+            int h = 0;
+            for(int i = 0; i < partial.num_words(); i++)
+            {
+                for(uint64_t word = partial.data()[i]; word != 0; word &= word - 1)
+                {
+                    int cost = start_costs[(i << 6) + lowest_bit64(word)];
+                    if(cost == DEAD_END)
+                    {
+                        return DEAD_END;
+                    }
+                    h = (options.heuristic == H_MAX) ? max(h, cost) : h + cost;
+                }
+            }
+            return h;
         }
 
-        //@TODO: Update heuristic function
-        //returns the h value of the input node
-        int calculate_h(symbo_node* node)
+        //registers a regressed partial state and opens the path to it unless a path as short is known. Partial states
+        //holding a mutex pair or an atom the start cannot reach even under the relaxation are dropped
+        void open_partial_state(const state_view& partial, int g, state_id parent, int op)
         {
-            // return 0;
-            
-            if(!is_heuristic && false) //removing for speed
+            if(!regression_mutexes.consistent(partial))
             {
-                // printf("++++++++++++++++++++ HEURISTIC++++++++++++++++\n");
-                symbo_planner temp = *this;
-                heuristic_planner = &temp;
-                heuristic_planner->heuristic_reset(node);
-                heuristic_planner->generate_tree();
-                cout << "Heuristic value " << heuristic_planner->get_goal_ct() <<endl;
-                // printf("++++++++++++++++++++ HEURISTIC END++++++++++++++++\n");
-
-                return heuristic_planner->get_goal_ct();
+                return;
             }
-            else 
+            uint64_t hash = zobrist.hash(partial);
+            state_id existing = back_registry.find(partial, hash);
+            if(existing != NO_STATE && back_info.g[existing] <= g)
             {
-                return goal_diff(node);
+                return;
             }
-
-        } 
-
-        int goal_diff(symbo_node* node)
-        {
-            int count = 0;
-            unordered_set<Condition, ConditionHasher, ConditionComparator> node_cond = node->get_state();
-            for(auto cond : goal_condition)
+            pair<state_id, bool> result = back_registry.insert(partial, hash);
+            state_id id = result.first;
+            if(result.second)
             {
-                if(find(node_cond.begin(), node_cond.end(), cond) == node_cond.end()) //condition satisfied
+                back_info.resize(back_registry.size());
+                back_info.h[id] = regression_h(partial);
+                for(int i = 0; i < partial.num_words(); i++) //anchored on its lowest atom
                 {
-                    count++;
+                    if(partial.data()[i] != 0)
+                    {
+                        anchored[(i << 6) + lowest_bit64(partial.data()[i])].push_back(id);
+                        break;
+                    }
                 }
             }
-            return count;
+            if(back_info.h[id] == DEAD_END)
+            {
+                return;
+            }
+            back_info.g[id] = g;
+            back_info.parent[id] = parent;
+            back_info.creating_op[id] = op;
+            back_info.closed[id] = 0;
+            int weighted_h = weight*back_info.h[id];
+            back_open.push(open_entry{g + weighted_h, weighted_h, g, id, parent, op}); //assumes that all actions have equal cost
+            probe_expanded_states(id, partial);
         }
 
-        vector<string> uset_to_vec(unordered_set<string> in_list)
+        //expands the best partial state. An operator is relevant if it adds one of its atoms and consistent if it
+        //deletes none of them without adding it back; the regressed state drops the added atoms and needs the
+        //preconditions. Meetings with the new partial states are recorded when they are opened
+        void regression_step()
         {
-            vector<string> ret_vec; 
-            for(auto s : in_list)
+            open_entry current = back_open.top();
+            back_open.pop();
+            back_info.closed[current.id] = 1;
+            expanded++;
+            state_view partial = back_registry.lookup_state(current.id, partial_words);
+
+            regression_stamp++;
+            vector<uint64_t> regressed(partial.num_words());
+            for(int i = 0; i < partial.num_words(); i++)
             {
-                ret_vec.push_back(s);
+                for(uint64_t word = partial.data()[i]; word != 0; word &= word - 1)
+                {
+                    for(int op_ind : achievers[(i << 6) + lowest_bit64(word)])
+                    {
+                        if(relevant_stamp[op_ind] == regression_stamp)
+                        {
+                            continue;
+                        }
+                        relevant_stamp[op_ind] = regression_stamp;
+                        const ground_operator& op = operators[op_ind];
+                        bool consistent = true;
+                        for(int w = 0; w < partial.num_words(); w++)
+                        {
+                            consistent &= (partial.data()[w] & op.del_mask.data()[w] & ~op.add_mask.data()[w]) == 0;
+                            regressed[w] = (partial.data()[w] & ~op.add_mask.data()[w]) | op.pre_mask.data()[w];
+                        }
+                        if(consistent)
+                        {
+                            open_partial_state(state_view(regressed.data(), regressed.size()), current.g + 1, current.id, op_ind);
+                        }
+                    }
+                }
             }
-            return ret_vec;
         }
 
-        void print_set(const list<string>& v) 
+        //drops stale entries from the top of the regression open list
+        bool back_open_empty()
         {
-            static int count = 0;
-            count++;
-            cout << "combination number " << count << ": [ ";
-            for (auto sym : v) 
-            { 
-                cout << sym << " ";
+            while(!back_open.empty() && (back_open.top().g > back_info.g[back_open.top().id] || back_info.closed[back_open.top().id]))
+            {
+                back_open.pop();
             }
-            cout << "] " << endl;
+            return back_open.empty();
         }
 
-        //generates (all permutations)  of k symbols
-        void k_combos(const vector<string> symbols, vector<list<string>> &combos, list<string> temp, int offset, int k)
+        //smallest f in the forward open lists, stale entries included so it may be lower than the real one
+        int forward_min_f()
         {
-            if (k == 0) {
-                // temp.sort(); //moved to sort the symbols on import
-                do //once a unique combination is generated, also add the permutations of that set
-                {
-                    combos.push_back(temp);
-                }while(next_permutation(temp.begin(), temp.end()));
-                // combos.push_back(temp);
-                return;
+            int f = INT32_MAX;
+            if(!open_list.empty())
+            {
+                f = open_list.top().f;
             }
-            for (int i = offset; i <= symbols.size() - k; ++i) 
+            if(!preferred_open.empty())
             {
-                temp.push_back(symbols[i]);
-                k_combos(symbols, combos, temp, i+1, k-1);
-                temp.pop_back();
+                f = min(f, preferred_open.top().f);
             }
+            return f;
         }
-        
-        bool in_closed(symbo_node* node)
+
+        //the operators from a partial state back to the goal, in forward order
+        void append_regression_plan(state_id partial, vector<int>& plan_ops)
         {
-            for(auto iter : closed_list)
+            for(state_id id = partial; back_info.parent[id] != NO_STATE; id = back_info.parent[id])
             {
-                if(node->get_state() == iter->get_state())
-                {
-                    // printf("new:    ");
-                    // node->print_state();
-                    // printf("closed: ");
-                    // iter->print_state();
-                    return true;
-
-                }
+                plan_ops.push_back(back_info.creating_op[id]);
             }
-            return false;
         }
 
-        void add_to_closed(symbo_node* node)
+        //keeps the meeting if its plan is cheaper than the best one so far
+        void record_meeting(state_id forward_state, state_id partial)
         {
-            closed_list.insert(node);
+            int cost = (forward_state == NO_STATE ? 0 : info.g[forward_state]) + back_info.g[partial];
+            if(cost < meeting_cost)
+            {
+                meeting_cost = cost;
+                meeting_state = forward_state;
+                meeting_partial = partial;
+            }
         }
 
-        vector<symbo_node*> generate_neighbors(symbo_node* parent_node)
+        //records the meetings of an expanded forward state with every partial state it satisfies, found through the
+        //anchor atoms of the state, and indexes the state for the partial states opened later
+        void find_meetings(state_id id)
         {
-            vector<symbo_node*> neighbors;     
-
-            // printf("Generating possible actions for start condition...\n");
-            for(auto act : actions) //iterating over all actions
+            state_view state = registry.lookup_state(id, meeting_words);
+            for(int i = 0; i < state.num_words(); i++)
             {
-                vector<list<string>> ac_inputs = generate_sym_combos(act.get_num_args());
-                // cout << "\nevaluating action " << act.toString() << ", " << act.get_num_args() << " inputs , "<< ac_inputs.size() << " generated combos " << endl;
-                for(auto input: ac_inputs)
+                for(uint64_t word = state.data()[i]; word != 0; word &= word - 1)
                 {
-                    // cout << "\t input( ";
-                    // for(auto l : input)
-                    // {
-                    //     cout << l << " "; 
-                    // }
-                    // printf(")\n");
-
-                    if(act.preconditions_satisfied(parent_node->get_state(),input))
+                    int atom_id = (i << 6) + lowest_bit64(word);
+                    for(state_id partial : anchored[atom_id])
                     {
-                        // cout << "\t input ( ";
-                        // for(auto l : input)
-                        // {
-                        //     cout << l << " "; 
-                        // }
-                        // printf(")\n");
-                        unordered_set<Condition, ConditionHasher, ConditionComparator> effect_state;
-                        if(!is_heuristic)
-                        {
-
-                            effect_state = act.execute_action(parent_node->get_state(),input);
-                        }
-                        else
-                        {
-                            effect_state = act.execute_action_no_removal(parent_node->get_state(),input);
-                        }
-
-                        symbo_node* node = new symbo_node(act.toString(), input, parent_node, effect_state, id_tracker++, parent_node->get_count()+1); 
-                        if(!in_closed(node)) //evaluate if not in the closed list 
-                        {
-                            if(false)
-                            {
-                                cout << "\nevaluating action " << act.toString()  << endl;
-
-                                cout << "\t input ( ";
-                                for(auto l : input)
-                                {
-                                    cout << l << " "; 
-                                }
-                                printf(")\n");
-                                printf("\t   Adding as valid action/state!\n");
-
-                                printf("\t   output is: ");
-                                for(auto es : effect_state)
-                                {
-                                    cout << " " << es.toString();
-                                }
-                                printf("\n");
-                            }
-                            
-
-                            parent_node->add_child(node); //bidirectionality
-                            neighbors.push_back(node);
-                        }
-                        else
+                        if(state.contains_all(back_registry.lookup_state(partial, partial_words)))
                         {
-                            // cout<< "Node " << node->get_id() << " is in the closed list!!!!!!" << endl;
-                            delete node;
+                            record_meeting(id, partial);
                         }
-
+                    }
+                    if(!meeting_indexed[id])
+                    {
+                        expanded_with[atom_id].push_back(id);
                     }
                 }
             }
-            return neighbors;
+            meeting_indexed[id] = 1;
         }
 
-        void evaluate_neighbors(symbo_node* parent_node)
+        //records the meetings of a newly opened partial state with the start and every expanded forward state that
+        //satisfies it. Only the states holding its rarest atom are compared
+        void probe_expanded_states(state_id partial_id, const state_view& partial)
         {
-            if(false)
+            if(start_condition.contains_all(partial))
             {
-                printf("\n-------\nEvaluating (%d)state ", parent_node->get_id());
-                for(auto es : parent_node->get_state())
+                record_meeting(NO_STATE, partial_id);
+            }
+            const vector<state_id>* rarest = nullptr;
+            for(int i = 0; i < partial.num_words(); i++)
+            {
+                for(uint64_t word = partial.data()[i]; word != 0; word &= word - 1)
                 {
-                    cout << " " << es.toString();
+                    const vector<state_id>& candidates = expanded_with[(i << 6) + lowest_bit64(word)];
+                    if(rarest == nullptr || candidates.size() < rarest->size())
+                    {
+                        rarest = &candidates;
+                    }
                 }
-                printf("\n");
             }
-            vector<symbo_node*> neighbors = generate_neighbors(parent_node);
-            for(auto neighbor: neighbors)
+            if(rarest == nullptr)
             {
-                update_costs(neighbor, parent_node->get_cost(), 3*calculate_h(neighbor));
-                // neighbor->print_full_prev_action_string();
-                // printf("Adding to open: ");
-                // neighbor->print_state(); 
-                add_to_open(neighbor);
+                return;
             }
-        }
-
-        void update_costs(symbo_node* node, int cumulative_cost, int heuristic_value)
-        {
-            node->set_cost(cumulative_cost + 1); //assumes that all actions have equal cost
-            node->set_h(heuristic_value);
-        }
-
-        bool is_goal(symbo_node* node)
-        {
-            // return node->get_state() == goal_condition;
-            unordered_set<Condition, ConditionHasher, ConditionComparator> node_cond = node->get_state();
-            for(auto cond : goal_condition)
+            for(state_id id : *rarest)
             {
-                if(find(node_cond.begin(), node_cond.end(), cond)== node_cond.end()) //fails to find
+                if(registry.lookup_state(id, meeting_words).contains_all(partial))
                 {
-                    return false;
+                    record_meeting(id, partial_id);
                 }
             }
-            return true;
         }
 
-        // adapted from https://stackoverflow.com/questions/12991758/creating-all-possible-k-combinations-of-n-items-in-c
-        vector<list<string>> generate_sym_combos(int num_symbols)
+        //regression alone, or front-to-front bidirectional search expanding the side with the smaller open list. A
+        //meeting is a forward state satisfying a partial state; both sides look for meetings, expanded forward states
+        //against every partial state and opened partial states against every expanded forward state. The search stops
+        //once no open entry on either side has an f below the cost of the cheapest meeting
+        void bidirectional_search()
         {
-            vector<list<string>> combinations;
-            list<string> tempo;
-            k_combos(symbols, combinations, tempo, 0, num_symbols);
-
-            if(false)
+            anchored.assign(index.size(), vector<state_id>());
+            expanded_with.assign(index.size(), vector<state_id>());
+            start_costs = relaxation.atom_costs(start_condition, options.heuristic == H_MAX ? relaxed_graph::MAXIMUM : relaxed_graph::ADDITIVE);
+            open_partial_state(goal_condition, 0, NO_STATE, -1);
+            bool forward = options.search == BIDIRECTIONAL;
+            while(!cancelled())
             {
-                printf("Complete.\n");
-                for(int i = 0; i < combinations.size(); ++i)
+                bool forward_open = forward && open_size() > 0;
+                bool backward_open = !back_open_empty();
+                if(!forward_open && !backward_open)
                 {
-                    print_set(combinations[i]);
+                    break;
+                }
+                int bound = max(forward_open ? forward_min_f() : 0, backward_open ? back_open.top().f : 0);
+                if(meeting_cost <= bound)
+                {
+                    break;
+                }
+                bool forward_turn = forward_open && (!backward_open || open_size() <= back_open.size());
+                if(!forward_turn)
+                {
+                    regression_step();
+                    continue;
+                }
+
+                open_entry current = get_next_from_open();
+                if(current.g > info.g[current.id] || info.closed[current.id])
+                {
+                    continue;
                 }
+                add_to_closed(current);
+                meeting_indexed.resize(registry.size());
+                find_meetings(current.id);
+                evaluate_neighbors(current.id);
             }
 
-            return combinations;
+            if(meeting_partial != NO_STATE && !cancelled())
+            {
+                vector<int> plan_ops;
+                for(state_id id = meeting_state; id != NO_STATE && info.parent[id] != NO_STATE; id = info.parent[id])
+                {
+                    plan_ops.push_back(info.creating_op[id]);
+                }
+                reverse(plan_ops.begin(), plan_ops.end());
+                append_regression_plan(meeting_partial, plan_ops);
+                report("\n\nthe goal has been found! :D\n");
+                report("Regression search registered %d partial states\n", back_registry.size());
+                goal_found = true;
+                generate_plan(plan_ops);
+                if(options.plan_callback)
+                {
+                    options.plan_callback(final_plan, plan_ops.size());
+                }
+                report("time elapsed:%g\n", cumulative_time());
+            }
+            else if(cancelled())
+            {
+                report("Search cancelled\n");
+            }
+            else
+            {
+                report("OL size is 0\n");
+            }
+            release_search_memory();
         }
 
-        void generate_plan(symbo_node* goal_node)
+        //starts the next anytime iteration: inconsistent states rejoin the open list, priorities are recomputed for
+        //the lowered weight and every state becomes expandable again
+        void reweight_open()
         {
-            if(nullptr != goal_node)
+            auto reweighted = [&](open_entry entry)
             {
-                vector<tuple<string, list<string>>> plan_vec; 
-                printf("Populating path...\n");
-                cout << "goal count is " << goal_node->get_count() << endl;
-                
-                symbo_node* current = new symbo_node();
-                current = goal_node;
-
-                symbo_node* prev = new symbo_node();
-                prev = goal_node->get_parent();
-
-                while(!(prev->get_is_start()))
-                {
-                    string prev_action_full = current->get_prev_action();
-                    int substring_ind = prev_action_full.find("(");
-                    tuple<string, list<string>> act_pair(prev_action_full.substr(0,substring_ind), current->get_prev_inputs());
-                    plan_vec.insert(plan_vec.begin(), act_pair);
-                    // cout << get<0>(act_pair) << "(";
-                    // for(auto in: get<1>(act_pair))
-                    // {
-                    //     cout << in << ",";
-                    // } 
-                    // cout << ")     (" << current->get_h() << ")" << endl;
-                    // current->print_full_prev_action_string();
-
-                    current = prev;
-                    prev = current->get_parent();
-                }
-                    string prev_action_full = current->get_prev_action();
-                    int substring_ind = prev_action_full.find("(");
-                    tuple<string, list<string>> act_pair(prev_action_full.substr(0,substring_ind), current->get_prev_inputs());
-                    plan_vec.insert(plan_vec.begin(), act_pair);
-                    // current->print_full_prev_action_string();
-
-                    // cout << "pushing back node  " << current->get_count() << endl;
-
-
-                //generating list of groundedActions
-                for(auto ac_pr: plan_vec)
+                entry.h = weight*max(info.h[entry.id], 0);
+                entry.f = entry.g + entry.h;
+                return entry;
+            };
+            //entries of states closed in this iteration are stale copies, the inconsistent states are added after
+            vector<open_entry> entries;
+            for(; !open_list.empty(); open_list.pop())
+            {
+                entries.push_back(open_list.top());
+            }
+            entries.erase(remove_if(entries.begin(), entries.end(), [&](const open_entry& entry) { return info.closed[entry.id]; }), entries.end());
+            entries.insert(entries.end(), incons.begin(), incons.end());
+            incons.clear();
+            for(const open_entry& entry : entries)
+            {
+                open_list.push(reweighted(entry));
+            }
+            entries.clear();
+            for(; !preferred_open.empty(); preferred_open.pop())
+            {
+                if(!info.closed[preferred_open.top().id])
                 {
-                    final_plan.push_back(GroundedAction(get<0>(ac_pr), get<1>(ac_pr)));
+                    entries.push_back(preferred_open.top());
                 }
-                printf("Population complete (%d expanded states) \n", closed_list.size());
-                // return actions;
             }
-            else 
+            for(const open_entry& entry : entries)
             {
-                printf("No goal found Failed to generate plan!\n");
+                preferred_open.push(reweighted(entry));
             }
-
+            fill(info.closed.begin(), info.closed.end(), 0);
         }
 
-        void start_timer()
+        //one HDA* partition: its own registry, search info and open list. Ids in open entries and in the registry are
+        //local, parents are global ids (local id * number of workers + owner) since they may live in another partition
+        struct state_message
         {
-            startTime = std::chrono::system_clock::now();
+            uint64_t hash;
+            int g;
+            state_id parent;
+            int op;
+            vector<uint64_t> words;
+        };
+        struct hda_worker
+        {
+            state_registry registry;
+            search_info info;
+            bucket_queue<open_entry> open;
+            mpsc_queue<state_message> inbox; //states generated by other workers that hash to this one
+            stubborn_sets pruning; //per-worker copy, it keeps scratch state
+            vector<uint64_t> lookup_words; //decodes the states the worker evaluates
+            int expanded = 0;
+        };
+        vector<unique_ptr<hda_worker>> hda_workers;
+        atomic<int> hda_active; //busy workers plus messages in flight, the search is over once it reaches 0
+        atomic<bool> hda_stop;
+        atomic<int> incumbent_cost; //cost of the best plan found by any worker
+        state_id incumbent_goal; //global id, guarded by incumbent_lock
+        mutex incumbent_lock;
+
+        int owner_of(uint64_t hash)
+        {
+            return (hash >> 40) % hda_workers.size(); //the registry tables index by the low bits
         }
-        
-        double cumulative_time()
+
+        //same role as register_state + open_successor for the partition of worker me
+        template<typename State>
+        void hda_open(int me, const State& state, uint64_t hash, int g, state_id parent, int op)
         {
-            std::chrono::time_point<std::chrono::system_clock> curTime = std::chrono::system_clock::now();
-            return ceil(std::chrono::duration_cast<std::chrono::milliseconds>(curTime - startTime).count()/1000);
+            hda_worker& w = *hda_workers[me];
+            state_id id = w.registry.find(state, hash);
+            if(id != NO_STATE && w.info.g[id] <= g)
+            {
+                return;
+            }
+            if(id == NO_STATE)
+            {
+                id = w.registry.insert(state, hash).first;
+                w.info.resize(w.registry.size());
+            }
+            if(w.info.h[id] < 0)
+            {
+                w.info.h[id] = calculate_h(w.registry.lookup_state(id, w.lookup_words), worker_relaxations[me]);
+            }
+            if(w.info.h[id] == DEAD_END)
+            {
+                return;
+            }
+            w.info.g[id] = g;
+            w.info.parent[id] = parent;
+            w.info.creating_op[id] = op;
+            w.info.closed[id] = 0; //a better path reopens an expanded state
+            int weighted_h = weight*w.info.h[id];
+            w.open.push(open_entry{g + weighted_h, weighted_h, g, id, parent, op}); //assumes that all actions have equal cost
         }
 
+        //a worker leaves the active count when it runs out of work and rejoins it before handling a message, senders
+        //count a message before publishing it. So the count only drops to 0 when no worker and no message is left
+        void hda_worker_loop(int me)
+        {
+            hda_worker& w = *hda_workers[me];
+            int num_workers = hda_workers.size();
+            bool idle = false;
+            state_message message;
+            vector<int> applicable;
+            vector<uint64_t> expanded_state;
+            while(!hda_stop.load(memory_order_acquire) && !cancelled())
+            {
+                while(w.inbox.pop(message))
+                {
+                    if(idle)
+                    {
+                        hda_active.fetch_add(1);
+                        idle = false;
+                    }
+                    hda_open(me, state_view(message.words.data(), message.words.size()), message.hash, message.g, message.parent, message.op);
+                    hda_active.fetch_sub(1);
+                }
+                //stale entries and paths that cannot beat the incumbent
+                while(!w.open.empty() && (w.open.top().g > w.info.g[w.open.top().id] || w.info.closed[w.open.top().id] 
+                    || w.open.top().f >= incumbent_cost.load(memory_order_relaxed)))
+                {
+                    w.open.pop();
+                }
+                if(w.open.empty())
+                {
+                    if(!idle)
+                    {
+                        idle = true;
+                        hda_active.fetch_sub(1);
+                    }
+                    if(hda_active.load() == 0)
+                    {
+                        hda_stop.store(true, memory_order_release);
+                    }
+                    this_thread::yield();
+                    continue;
+                }
 
+                open_entry current = w.open.top();
+                w.open.pop();
+                w.info.closed[current.id] = 1;
+                w.expanded++;
+                state_view state = w.registry.lookup_state(current.id, expanded_state);
+                state_id global = current.id * num_workers + me;
+                if(state.contains_all(goal_condition)) //goals are only accepted at expansion, as in A*
+                {
+                    lock_guard<mutex> guard(incumbent_lock);
+                    if(current.g < incumbent_cost.load())
+                    {
+                        incumbent_cost.store(current.g);
+                        incumbent_goal = global;
+                    }
+                    continue;
+                }
 
+                uint64_t hash = w.registry.get_hash(current.id);
+                applicable.clear();
+                successors.generate_applicable(state, applicable);
+                if(options.partial_order_reduction)
+                {
+                    w.pruning.prune(state, applicable);
+                }
+                for(int op_ind : applicable)
+                {
+                    successor_delta successor(state, operators[op_ind]);
+                    uint64_t child_hash = successor.hash(hash, zobrist);
+                    int owner = owner_of(child_hash);
+                    if(owner == me)
+                    {
+                        hda_open(me, successor, child_hash, current.g + 1, global, op_ind);
+                    }
+                    else if(current.g + 1 < incumbent_cost.load(memory_order_relaxed))
+                    {
+                        state_message outgoing{child_hash, current.g + 1, global, op_ind, vector<uint64_t>(state.num_words())};
+                        successor.materialize(outgoing.words.data());
+                        hda_active.fetch_add(1);
+                        hda_workers[owner]->inbox.push(std::move(outgoing));
+                    }
+                }
+            }
+        }
 
-    public: 
-        symbo_planner(unordered_set<Condition, ConditionHasher, ConditionComparator> start, 
-            unordered_set<Condition, ConditionHasher, ConditionComparator> goal, 
-            unordered_set<string> sym, 
-            unordered_set<Action, ActionHasher, ActionComparator> actions_in)
+        //hash-distributed A*: every worker runs hda_worker_loop on its partition until no work is left anywhere. Goals
+        //only set the incumbent, the search continues until nothing open can beat it, so with weight 1 and an
+        //admissible heuristic the plan is optimal
+        void hda_search()
+        {
+            int num_workers = workers.size();
+            hda_workers.clear();
+            for(int i = 0; i < num_workers; i++)
             {
-                this->goal_condition = goal;
-                this->start_condition = start; 
-                this->symbols = uset_to_vec(sym);
-                sort(symbols.begin(),symbols.end() ); //sorts symbols lexicographically so that permutations can take place.
-                this->actions = actions_in;
+                hda_workers.emplace_back(new hda_worker());
+                hda_workers.back()->registry.init(start_condition.num_words(), options.finite_domain_encoding ? &packer : nullptr);
+                hda_workers.back()->open.set_lifo(options.lifo_ties);
+                if(options.partial_order_reduction)
+                {
+                    hda_workers.back()->pruning = pruning;
+                }
             }
+            hda_active.store(num_workers + 1); //every worker starts busy, plus the start state message
+            hda_stop.store(false);
+            incumbent_cost.store(INT32_MAX);
+            incumbent_goal = NO_STATE;
+            uint64_t start_hash = zobrist.hash(start_condition);
+            state_message start_message{start_hash, 0, NO_STATE, -1, vector<uint64_t>(start_condition.data(), start_condition.data() + start_condition.num_words())};
+            hda_workers[owner_of(start_hash)]->inbox.push(std::move(start_message));
+
+            workers.run([&](int worker) { hda_worker_loop(worker); });
+
+            int total_expanded = 0;
+            string distribution;
+            for(const unique_ptr<hda_worker>& w : hda_workers)
+            {
+                total_expanded += w->expanded;
+                distribution += " " + to_string(w->expanded);
+                pruning.add_counts(w->pruning);
+            }
+            report("HDA* on %d workers, expansions per worker:%s\n", num_workers, distribution.c_str());
+            print_pruning();
+            if(incumbent_goal != NO_STATE)
+            {
+                report("\n\nthe goal has been found! :D\n");
+                report("Populating path...\n");
+                report("goal count is %d\n", incumbent_cost.load());
+                vector<tuple<string, list<string>>> plan_vec; 
+                for(state_id current = incumbent_goal; current != NO_STATE; )
+                {
+                    const search_info& owner_info = hda_workers[current % num_workers]->info;
+                    state_id local = current / num_workers;
+                    if(owner_info.parent[local] == NO_STATE)
+                    {
+                        break;
+                    }
+                    plan_vec.insert(plan_vec.begin(), op_to_pair(owner_info.creating_op[local]));
+                    current = owner_info.parent[local];
+                }
+                for(auto ac_pr: plan_vec)
+                {
+                    final_plan.push_back(GroundedAction(get<0>(ac_pr), get<1>(ac_pr)));
+                }
+                report("Population complete (%d expanded states) \n", total_expanded);
+                report("%.0f expansions per second\n", total_expanded / max(elapsed_seconds(), 1e-6));
+                report("time elapsed:%g\n", cumulative_time());
+                goal_found = true;
+                if(options.plan_callback)
+                {
+                    options.plan_callback(final_plan, incumbent_cost.load());
+                }
+            }
+            else
+            {
+                report("OL size is 0\n");
+            }
+            hda_workers.clear();
+        }
 
         void generate_tree()
         {
             start_timer();
-            symbo_node* start = new symbo_node("NONE", {"NONE", "NONE"}, nullptr, start_condition, this->id_tracker++,0);
-            start->set_is_start(true);
-            add_to_open(start);
-            symbo_node* goal_node = nullptr; 
+            weight = options.weight;
+            if(options.search == HDA_STAR)
+            {
+                if(options.heuristic != LM_COUNT)
+                {
+                    hda_search();
+                    return;
+                }
+                report("HDA* needs a heuristic of the state alone, running the sequential search for LM_COUNT\n");
+            }
+            state_id start;
+            if(use_symmetries)
+            {
+                state_view representative = canonical_form(start_condition);
+                start = register_state(representative, zobrist.hash(representative));
+            }
+            else
+            {
+                start = register_state(start_condition, zobrist.hash(start_condition));
+            }
+            bool greedy = options.search == GBFS || options.search == EHC;
+            if(options.heuristic == LM_COUNT)
+            {
+                landmarks.init_start(start, start_condition);
+                info.h[start] = landmarks.count(start, start_condition);
+            }
+            else
+            {
+                info.h[start] = calculate_h(start_condition, relaxation);
+            }
+            if(options.search == EHC && info.h[start] != DEAD_END)
+            {
+                vector<int> plan_ops;
+                if(enforced_hill_climbing(start, plan_ops))
+                {
+                    report("\n\nthe goal has been found! :D\n");
+                    goal_found = true;
+                    generate_plan(plan_ops);
+                    if(options.plan_callback)
+                    {
+                        options.plan_callback(final_plan, plan_ops.size());
+                    }
+                    report("time elapsed:%g\n", cumulative_time());
+                    release_search_memory();
+                    return;
+                }
+                report("Enforced hill-climbing got stuck after %d expansions, falling back to greedy best-first search\n", expanded);
+            }
+            record_path(start, 0, NO_STATE, -1);
+            if(info.h[start] != DEAD_END)
+            {
+                add_to_open(open_entry{0, greedy ? 0 : (int)(weight*info.h[start]), 0, start, NO_STATE, -1});
+            }
+            if(options.search == REGRESSION || options.search == BIDIRECTIONAL)
+            {
+                bidirectional_search();
+                return;
+            }
+            state_id goal_node = NO_STATE; 
+            int plan_cost = INT32_MAX;
 
-            while( (open_list.size() != 0) && !goal_found)
+            while(true)
             {
-                symbo_node* current = get_next_from_open();
-                if(!in_closed(current))
+                state_id found = greedy ? lazy_search_iteration() : search_iteration(plan_cost);
+                if(found != NO_STATE && info.g[found] < plan_cost)
                 {
-                    evaluate_neighbors(current);
-                    add_to_closed(current);
-                    if(is_goal(current))
+                    report("\n\nthe goal has been found! :D\n");
+                    goal_found = true;
+                    goal_node = found;
+                    plan_cost = info.g[found];
+                    final_plan.clear();
+                    generate_plan(goal_node);
+                    if(options.anytime)
                     {
-                        goal_found = true;
-                        goal_node = current;
+                        report("Published plan of cost %d at weight %.2f after %.3fs\n", plan_cost, weight, elapsed_seconds());
                     }
+                    if(options.plan_callback)
+                    {
+                        options.plan_callback(final_plan, plan_cost);
+                    }
+                }
+                if(greedy || !options.anytime || !goal_found || cancelled() || weight <= 1.0 || open_size() + incons.size() == 0 
+                    || elapsed_seconds() > options.deadline_seconds)
+                {
+                    break;
                 }
+                weight = max(1.0, weight - options.weight_decrement);
+                reweight_open();
             }
             
-            if(is_heuristic && goal_found )
+            if(goal_found)
             {
-                goal_ct = goal_node->get_count();
+                if(options.anytime)
+                {
+                    report("Anytime search stopped at weight %.2f with plan cost %d\n", weight, plan_cost);
+                }
+                if(options.preferred_operators)
+                {
+                    report("%d of %d expansions taken from the preferred list\n", preferred_expansions, expanded);
+                }
+                report("time elapsed:%g\n", cumulative_time());
             }
-            else if(!is_heuristic && goal_found)
+            else if(cancelled())
             {
-                printf("\n\nthe goal has been found! :D\n");
-                generate_plan(goal_node);
-                cout << "time elapsed:"  << cumulative_time() <<endl;
+                report("Search cancelled\n");
             }
-            else if(open_list.size() == 0)
+            else if(open_size() == 0)
             {
-                printf("OL size is 0\n");
+                report("OL size is 0\n");
             }
             else
             {
-                printf("ERROR IDKY\n");
+                report("ERROR IDKY\n");
             }
 
-
+            release_search_memory();
         }
 
         list<GroundedAction> get_plan()
@@ -1562,24 +5771,52 @@ class symbo_planner
 
         
 
-        int get_goal_ct()
-        {
-            return this->goal_ct;
-        }
+
         
 
 
 
 };
 
+//configurations raced by the portfolio mode of planner()
+vector<planner_options> default_portfolio()
+{
+    vector<planner_options> configs(4);
+    configs[0].weight = 1.0; //A* with goal count
+    configs[1].weight = 3.0; //weighted A* with goal count
+    configs[2].search = GBFS; //lazy greedy best-first with FF and preferred operators
+    configs[2].heuristic = FF;
+    configs[2].preferred_operators = true;
+    configs[3].heuristic = LM_COUNT;
+    return configs;
+}
+
 list<GroundedAction> planner(Env* env)
 {
     // this is where you insert your planner
-    symbo_planner symbolic_planner = symbo_planner(env->get_initial_ungrounded(), env->get_goal_ungrounded(), env->get_symbols(), env->get_actions());
+    planner_options options;
+    options.heuristic = GOAL_COUNT; //GOAL_COUNT, H_ADD, H_MAX, FF, LM_COUNT or PDB
+    options.preferred_operators = false;
+    options.weight = 3.0;
+    options.anytime = false;
+    options.search = BEST_FIRST; //BEST_FIRST, HDA_STAR, GBFS, EHC, REGRESSION or BIDIRECTIONAL
+    options.threads = 1;
+    options.partial_order_reduction = false;
+    options.symmetry_reduction = false;
+    options.finite_domain_encoding = false;
+    symbo_planner symbolic_planner(env->get_initial_ungrounded(), env->get_goal_ungrounded(), env->get_symbols(), env->get_actions(), options);
 
     printf("\n\n**** Debugging Area **** \n\n");
 
-    symbolic_planner.generate_tree();
+    bool portfolio = false; //race default_portfolio() instead of the single configuration above
+    if(portfolio)
+    {
+        symbolic_planner.run_portfolio(default_portfolio(), true, 10.0);
+    }
+    else
+    {
+        symbolic_planner.generate_tree();
+    }
     
     printf("\n**** End of Debugging Area **** \n\n\n");
     // blocks world example